@@ -9,100 +9,28 @@
 
 #include "Board.h"
 #include "OnlineMedian.h"
+#include "Simulation.h"
+#include "SafeMoves.h"
 
 using namespace std;
 
-struct Move {
-    int dir;
-    bool bomb;
-
-    Move() {}
-
-    Move(int dir, bool bomb) : dir(dir), bomb(bomb) {}
-};
-
-class SimBot {
-public:
-    virtual Move move(Board& b) = 0;
-    virtual void setTurn(int turn) {};
-    virtual int player() = 0;
-};
-
-class MinimalBot: public SimBot {
-    int player_;
-
-public:
-    MinimalBot() {}
-    MinimalBot(int player) : player_(player) {}
-
-    Move move(Board& b) {
-        return Move(Position::Dir::NONE, false);
-    }
-
-    int player() {
-        return player_;
-    }
-};
-
-class CustomAI : public SimBot {
-    const Move* moves;
-    int turn = 0;
-    int player_;
-
-public:
-    CustomAI(int player, const Move moves[], int startFromTurn) :
-            player_(player), moves(moves), turn(startFromTurn) {}
-
-    void setTurn(int fromTurn) {
-        turn = fromTurn;
-    }
-
-    Move move(Board& b) {
-        return moves[turn++];
-    }
-
-    int player() {
-        return player_;
-    }
-};
-
-struct ScoreFactors {
-    double boxesDestroyed;
-    double boxDepreciation;
-    double rangePU;
-    double countPU;
-    double enemyDeath;
-    double victory;
-    double defeat;
-};
-
-static ScoreFactors defaultFactors = {
-    1.0,        // boxesDestroyed
-    0.875,      // boxDepreciation
-    0.1,        // rangePU
-    0.1,        // countPU
-    50,         // enemyDeath
-    200,        // victory
-    -200        // defeat
-};
-
 template<int TURNS, int PLAYERS>
-class AnnealingBot {
+class AnnealingBot : public Simulation<TURNS, PLAYERS> {
+    typedef Simulation<TURNS, PLAYERS> Sim;
+    using Sim::player;
+    using Sim::simHistory;
 public:
-    ScoreFactors sFactors = defaultFactors;
+    using Sim::score;
+    // Runtime configurable so the tuner can search it. See TunedParams.h for the defaults.
+    AnnealingSchedule schedule = defaultSchedule;
+    // No logging, for self-play, where many games run at once and nobody reads it.
+    bool quiet = false;
 private:
     static constexpr float maxScore = 10000;
     static constexpr float minScore = 0;
     // Loop control and timing.
     static const int reevalPeriodMilli = 4;
     static const int timeBufferMilli = 1;
-    static constexpr float initTemp = 23000.0; // TODO
-    static constexpr float initCoolingFraction = 0.95;
-    static constexpr float startAcceptanceRate = 0.96;
-    static constexpr float endAcceptanceRate = 0.00000000001; // TODO
-    static constexpr float stepsVsCoolRatio = 1.3;
-    static const int initCoolingSteps = 160; // TODO
-    static const int initStepsPerTemp = 140; // TODO
     long long startTime;
     static const int UNSET = -1;
     long allocatedTime = UNSET;
@@ -113,10 +41,10 @@ private:
     int nonTunnelCount = 0;
     int simsSinceUpdate = 0;
     int coolCount = 0;
-    int coolingSteps = initCoolingSteps;
+    int coolingSteps = defaultSchedule.initCoolingSteps;
     int coolingIdx = 0;
-    int stepsPerTemp = initStepsPerTemp;
-    float currentTemp = initTemp;
+    int stepsPerTemp = defaultSchedule.initStepsPerTemp;
+    float currentTemp = defaultSchedule.initTemp;
     float coolingFraction = UNSET;//initCoolingFraction;
     bool toDeleteEnemy = false;
     // SD & mean
@@ -124,11 +52,8 @@ private:
     double M2;
     OnlineMedian<float> onlineMedian;
 
-    int player;
-    SimBot **enemyBots;
     Move previousSolution[TURNS];
     bool hasPrevious = false;
-    Board simHistory[TURNS + 1];
 
     long long getTimeMilli() {
         long long ms = chrono::duration_cast<chrono::milliseconds>(
@@ -144,7 +69,7 @@ private:
         if (timeRemaining < 0) {
             coolingSteps = 0;
             stepsPerTemp = 0;
-            cerr << "Tunnel %: " << (float) tunnelCount / (tunnelCount + nonTunnelCount) << endl;
+            if(!quiet) cerr << "Tunnel %: " << (float) tunnelCount / (tunnelCount + nonTunnelCount) << endl;
         } else if (elapsed > reevalPeriodMilli) {
             // The update timer has elapsed, or we are on our second loop, so need to create a better estimate of
             // start temp, end temp and cooling fraction.
@@ -153,8 +78,8 @@ private:
             int simsRemaining = simRate * timeRemaining;
             // A*2A = C
             // A = sqrt(C/2)
-            coolingSteps = sqrt((simCount + simsRemaining) / (stepsVsCoolRatio));
-            stepsPerTemp = coolingSteps * stepsVsCoolRatio;
+            coolingSteps = sqrt((simCount + simsRemaining) / (schedule.stepsVsCoolRatio));
+            stepsPerTemp = coolingSteps * schedule.stepsVsCoolRatio;
             //            cerr << "Tunnel %: " << (float) tunnelCount / (tunnelCount + nonTunnelCount) << endl;
             tunnelCount = 0;
             nonTunnelCount = 0;
@@ -168,8 +93,8 @@ private:
             //            cerr << "SD: " << SD << endl;
             float median = onlineMedian.median();
             //            cerr << "mean: " << mean << "    median: " << median << endl;
-            float startTemp = -median / log(startAcceptanceRate);
-            float endTemp = -median / log(endAcceptanceRate);
+            float startTemp = -median / log(schedule.startAcceptanceRate);
+            float endTemp = -median / log(schedule.endAcceptanceRate);
             coolingFraction = pow(endTemp / startTemp, 1.0 / (coolingSteps * 0.6));
             currentTemp = startTemp * pow(coolingFraction, coolingIdx);
             //            cerr << "Current Temp: " << currentTemp << "    coolingIdx: " << coolingIdx << endl;
@@ -180,10 +105,10 @@ private:
     void init() {
         startTime = getTimeMilli();
         lastUpdateTime = startTime;
-        currentTemp = initTemp;
-        coolingSteps = allocatedTime == UNSET ? initCoolingSteps : allocatedTime * 1.2;
-        coolingFraction = initCoolingFraction;
-        stepsPerTemp = initStepsPerTemp;
+        currentTemp = schedule.initTemp;
+        coolingSteps = allocatedTime == UNSET ? schedule.initCoolingSteps : allocatedTime * 1.2;
+        coolingFraction = schedule.initCoolingFraction;
+        stepsPerTemp = schedule.initStepsPerTemp;
         simCount = 0;
         tunnelCount = 0;
         nonTunnelCount = 0;
@@ -199,11 +124,7 @@ private:
 public:
     AnnealingBot() {}
 
-    AnnealingBot(int player, long allocatedTimeMilli) : player(player), allocatedTime(allocatedTimeMilli) {}
-
-    void setEnemyAI(SimBot* enemyAI[]) {
-        enemyBots = enemyAI;
-    }
+    AnnealingBot(int player, long allocatedTimeMilli) : Sim(player), allocatedTime(allocatedTimeMilli) {}
 
 
     Move random() {
@@ -225,13 +146,19 @@ public:
             m.bomb = !m.bomb;
         } else {
             int count = 0;
-            int n;
+            const Board& b = simHistory[turn];
+            // Directions which leave a way out of the known explosions, or failing that any free one.
+            const bool bomb = m.bomb && SafeMoves::canBomb(b, player);
+            int safe = SafeMoves::survivable(b, player, Bomb::TIMEOUT);
             for (int i = Position::NONE; i >= Position::RIGHT; i--) {
+                if(i != m.dir && (safe & SafeMoves::bit(i, bomb))) dir[count++] = i;
+            }
+            for (int i = Position::NONE; i >= Position::RIGHT && count == 0; i--) {
                 if(i == m.dir) continue;
-                const Position p = Board::toPosition(simHistory[turn].players[player].tile);
-                n = Board::tileAt(p, i, 1);
-                if (n == Board::INVALID_TILE || simHistory[turn].tiles[n] == Board::WALL) continue;
-                if (simHistory[turn].willBeFree(n, 1, i)) {
+                const Position p = Board::toPosition(b.players[player].tile);
+                int n = Board::tileAt(p, i, 1);
+                if (n == Board::INVALID_TILE || b.tiles[n] == Board::WALL) continue;
+                if (b.willBeFree(n, 1, i)) {
                     dir[count++] = i;
                 }
             }
@@ -251,88 +178,6 @@ public:
         }
     }
 
-    // Use sim history
-    double score() {
-        const Board& endBoard = simHistory[TURNS];
-        const Board& startBoard = simHistory[0];
-        double score = 0;
-        // Victory & Defeat
-        // Should be broken up to determine the placing. 3rd is better than 4th.
-        if(!endBoard.players[player].isAlive()) {
-            return sFactors.defeat;
-        } else if(endBoard.aliveCount == 1) {
-            // Only player left is us.
-            return  sFactors.victory;
-        } else {
-            score += (Board::playerCount - endBoard.aliveCount) * sFactors.enemyDeath;
-        }
-
-        // Continued survival
-        int turnsLeftAlive = endBoard.survivalTurns(player, Bomb::TIMEOUT);
-        if(turnsLeftAlive < Bomb::TIMEOUT) {
-            return sFactors.defeat * (Bomb::TIMEOUT - turnsLeftAlive) / Bomb::TIMEOUT;
-        }
-
-        // Box counts
-        // Haven't yet given any depreciation to the pre-survival box counts.
-        int beforeBoxCount = startBoard.players[player].boxesDestroyed;
-        int afterBoxCount = endBoard.players[player].boxesDestroyed;
-        score += (afterBoxCount - beforeBoxCount) * sFactors.boxesDestroyed;
-
-        for(int i = 0; i < Bomb::TIMEOUT; i++) {
-            score += sFactors.boxesDestroyed * endBoard.scoresM[i][player] * pow(sFactors.boxDepreciation, i + 1);
-        }
-        return score;
-    }
-
-    int simulate(SimBot* ourSim, SimBot* enemySims[], int startFromTurn) {
-        // Assuming the board has had stepForward called for the very first board.
-        Move m;
-        for(int i = startFromTurn; i < TURNS; i++) {
-            simHistory[i+1]  = simHistory[i];
-            // Us move first? Place our bomb first?
-            if(simHistory[i+1].players[player].isAlive()) {
-                m = ourSim->move(simHistory[i + 1]);
-                if(simHistory[i+1].canMove(player, m.dir)) {
-                    if(m.bomb) {
-                        simHistory[i+1].placeBomb(player);
-                    }
-                    simHistory[i+1].move(player, m.dir);
-                } else {
-                    return i;
-                }
-            }
-            for(int p = 0; p < PLAYERS - 1; p++) {
-                if(simHistory[i+1].players[enemySims[p]->player()].isAlive()) {
-                    m = enemySims[p]->move(simHistory[i+1]);
-                    if(simHistory[i+1].canMove(p, m.dir)) {
-                        if(m.bomb) {
-                            simHistory[i+1].placeBomb(p);
-                        }
-                        simHistory[i+1].move(p, m.dir);
-                    } else {
-                        simHistory[i+1].move(p, Position::Dir::NONE);
-                    }
-                }
-            }
-            simHistory[i+1].stepForward(1);
-        }
-        return TURNS-1;
-    }
-
-    double score(const Move solution[], int startFromTurn) {
-        CustomAI *customAI = new CustomAI(player, solution, startFromTurn);
-        for(int i = 0; i < PLAYERS - 1; i++) {
-            enemyBots[i]->setTurn(startFromTurn);
-        }
-        int validUntil = simulate(customAI, enemyBots, startFromTurn);
-        if(validUntil < (TURNS - 1)) {
-            return -10000; // Hacky. Just needs to be big number.
-        }
-        delete(customAI); // WHY USE HEAP?
-        return -score();
-    }
-
     void train(Board board, Move solution[TURNS]) {
         board.stepForward(1);
         init();
@@ -432,7 +277,7 @@ public:
             currentTemp *= coolingFraction;
         }
 //    cerr << "End score: " << currentScore << endl;
-        cerr << "Sim count:" << simCount << endl;
+        if(!quiet) cerr << "Sim count:" << simCount << endl;
 //    cerr << "Average score diff: " << diffSum / simCount << endl;
         memcpy(solution, best, TURNS*sizeof(Move));
 //    cerr << "Current (pos, vel)   " << podsToTrain[0].pos << "   " << podsToTrain[0].vel << endl;
@@ -0,0 +1,5 @@
+#include "BeamBot.h"
+
+const int BeamBot::MAX_PLIES;
+const int BeamBot::DEFAULT_WIDTH;
+const int BeamBot::UNSET;
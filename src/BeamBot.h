@@ -0,0 +1,280 @@
+#ifndef HYPERSONIC_BEAMBOT_H
+#define HYPERSONIC_BEAMBOT_H
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "Board.h"
+#include "Mechanics.h"
+#include "TurnContext.h"
+#include "SafeMoves.h"
+#include "Bot.h"
+#include "MemoryArena.h"
+
+using namespace std;
+
+/* Beam search over our own moves.
+ * Each ply keeps the best beamWidth boards by the Bot leaf heuristic. The two layers (current and next) are swapped
+ * each ply; their boards are a pool taken from the thread's arena for the move, and the rest is preallocated, so
+ * nothing is allocated while searching. Duplicate states reached by
+ * different move orders are pruned by their Board::stateHash(). The search deepens until the time allocation
+ * runs out, or maxPlies (at most MAX_PLIES) is reached.
+ **/
+class BeamBot {
+public:
+    static const int MAX_PLIES = 20;
+    static const int DEFAULT_WIDTH = 100;
+    static const int UNSET = -1;
+
+    Move plan[MAX_PLIES];
+    int planLength = 0;
+    int depthReached = 0;
+    bool distEnabled = true;
+    int maxPlies = MAX_PLIES;
+
+private:
+    static const int SURVIVAL_TURNS = 8;
+    static const int MOVES_PER_NODE = Position::DIR_COUNT * 2;
+
+    int player;
+    long allocatedTime = UNSET;
+    long long startTime;
+    int width = 0;
+    // The exhaustive search's weights, so the beam ranks boards the same way.
+    BotFactors factors;
+    double depreciation[MAX_PLIES + Bomb::TIMEOUT + 2];
+    const TurnContext* context = NULL;
+
+    // Two layers, used as a ring: layer (depth % 2) is being expanded into layer ((depth + 1) % 2).
+    ArenaPool<Board> boards;
+    Board* layers[2] = {NULL, NULL};
+    vector<double> evals[2];
+    vector<double> accumulated[2];
+    vector<uint64_t> hashes[2];
+    int layerSize[2] = {0, 0};
+    // Min-heap of slot indices in the layer being filled, ordered by eval. The root is the slot to evict.
+    vector<int> heap;
+    bool heapDirty = false;
+    // Open addressing, hash -> slot. A slot which has since been overwritten no longer matches its hash.
+    vector<uint64_t> tableKeys;
+    vector<int> tableSlots;
+    uint64_t tableMask = 0;
+    // Per ply history, for rebuilding the plan of the best board.
+    vector<Move> moves;
+    vector<int> parents;
+    Board child;
+
+    long long getTimeMilli() {
+        return chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    bool outOfTime() {
+        return allocatedTime != UNSET && getTimeMilli() - startTime >= allocatedTime;
+    }
+
+    struct EvalGreater {
+        const vector<double>* evals;
+        bool operator()(int a, int b) const {
+            return (*evals)[a] > (*evals)[b];
+        }
+    };
+
+    // Leaf heuristic of Bot::score (without the fight and flee modes).
+    double evaluate(const Board& b, int depth, double acc) {
+        double score = acc;
+        int turnsLeftAlive = b.survivalTurns(player, SURVIVAL_TURNS);
+        if(turnsLeftAlive < SURVIVAL_TURNS) {
+            score += -1000 * (SURVIVAL_TURNS - turnsLeftAlive);
+        }
+        score += factors.powerupSF * b.players[player].totalBombs * depreciation[depth];
+        score += factors.powerupSF * b.players[player].range * depreciation[depth];
+        score += factors.bombsAvailableSF * b.players[player].bombsAvailable;
+        for(int i = 0; i < Bomb::TIMEOUT; i++) {
+            score += factors.boxSF * b.scores(i)[player] * depreciation[depth + i + 1];
+        }
+        if(distEnabled) {
+            int boxDist = BoardStats::stepsToClosestBox(b, player, context);
+            if(boxDist != -1) {
+                score -= factors.closestSF * boxDist;
+            }
+        }
+        return score;
+    }
+
+    int findSlot(int layer, uint64_t h, int* entry) {
+        uint64_t i = h & tableMask;
+        while(tableSlots[i] != UNSET) {
+            if(tableKeys[i] == h) {
+                *entry = i;
+                int slot = tableSlots[i];
+                return hashes[layer][slot] == h ? slot : UNSET;
+            }
+            i = (i + 1) & tableMask;
+        }
+        *entry = i;
+        return UNSET;
+    }
+
+    void insert(int layer, int depth, double eval, double acc, uint64_t h, Move m, int parent) {
+        int entry;
+        int slot = findSlot(layer, h, &entry);
+        EvalGreater cmp = {&evals[layer]};
+        if(slot != UNSET) {
+            // Same state reached by another move order. Keep the better one.
+            if(eval <= evals[layer][slot]) return;
+            heapDirty = true;
+        } else if(layerSize[layer] < width) {
+            slot = layerSize[layer]++;
+            heap.push_back(slot);
+        } else {
+            if(heapDirty) {
+                make_heap(heap.begin(), heap.end(), cmp);
+                heapDirty = false;
+            }
+            slot = heap.front();
+            if(eval <= evals[layer][slot]) return;
+            pop_heap(heap.begin(), heap.end(), cmp);
+        }
+        layers[layer][slot] = child;
+        evals[layer][slot] = eval;
+        accumulated[layer][slot] = acc;
+        hashes[layer][slot] = h;
+        moves[depth * width + slot] = m;
+        parents[depth * width + slot] = parent;
+        tableKeys[entry] = h;
+        tableSlots[entry] = slot;
+        if(!heapDirty && heap.back() == slot) {
+            push_heap(heap.begin(), heap.end(), cmp);
+        }
+    }
+
+    void expand(int from, int to, int depth) {
+        layerSize[to] = 0;
+        heap.clear();
+        heapDirty = false;
+        fill(tableSlots.begin(), tableSlots.end(), (int) UNSET);
+        for(int n = 0; n < layerSize[from]; n++) {
+            const Board& b = layers[from][n];
+            // Children which certainly die are skipped before they are copied and stepped.
+            const int safe = SafeMoves::survivable(b, player, 1);
+            for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+                for(int bomb = 1; bomb >= 0; bomb--) {
+                    if(!(safe & SafeMoves::bit(d, bomb))) continue;
+                    child = b;
+                    if(bomb) {
+                        child.placeBomb(player);
+                    }
+                    child.move(player, d);
+                    int beforeBoxCount = child.players[player].boxesDestroyed;
+                    child.stepForward(1);
+                    if(!child.players[player].isAlive()) continue;
+                    double acc = accumulated[from][n] + factors.boxSF *
+                            (child.players[player].boxesDestroyed - beforeBoxCount) * depreciation[depth];
+                    insert(to, depth, evaluate(child, depth, acc), acc, child.stateHash(), Move(d, bomb), n);
+                }
+            }
+            if(depth > 1 && outOfTime()) {
+                // An incomplete ply is biased towards the early nodes, so discard it. The first ply is always
+                // completed so there is a move to return.
+                layerSize[to] = 0;
+                return;
+            }
+        }
+    }
+
+    void rebuildPlan(int layer, int depth) {
+        int best = 0;
+        for(int i = 1; i < layerSize[layer]; i++) {
+            if(evals[layer][i] > evals[layer][best]) best = i;
+        }
+        planLength = depth;
+        for(int d = depth; d >= 1; d--) {
+            plan[d - 1] = moves[d * width + best];
+            best = parents[d * width + best];
+        }
+    }
+
+public:
+    BeamBot(int player, long allocatedTimeMilli = UNSET, int beamWidth = DEFAULT_WIDTH) :
+            player(player), allocatedTime(allocatedTimeMilli) {
+        setFactors(defaultBotFactors);
+        setBeamWidth(beamWidth);
+    }
+
+    void setFactors(const BotFactors& f) {
+        factors = f;
+        for(int i = 0; i < MAX_PLIES + Bomb::TIMEOUT + 2; i++) {
+            depreciation[i] = pow(factors.boxDepreciation, i);
+        }
+    }
+
+    void setContext(const TurnContext* c) {
+        context = c;
+    }
+
+    void setBeamWidth(int beamWidth) {
+        if(beamWidth == width) return;
+        width = beamWidth;
+        for(int i = 0; i < 2; i++) {
+            evals[i].resize(width);
+            accumulated[i].resize(width);
+            hashes[i].resize(width);
+        }
+        heap.reserve(width);
+        // Room for every child of a full layer at a load factor of 1/2.
+        uint64_t tableSize = 1;
+        while(tableSize < (uint64_t) width * MOVES_PER_NODE * 2) tableSize <<= 1;
+        tableKeys.assign(tableSize, 0);
+        tableSlots.assign(tableSize, UNSET);
+        tableMask = tableSize - 1;
+        moves.resize((MAX_PLIES + 1) * width);
+        parents.resize((MAX_PLIES + 1) * width);
+    }
+
+    int beamWidth() const {
+        return width;
+    }
+
+    void setAllocatedTime(long allocatedTimeMilli) {
+        allocatedTime = allocatedTimeMilli;
+    }
+
+    pair<int, bool> move(Board b) {
+        startTime = getTimeMilli();
+        planLength = 0;
+        depthReached = 0;
+        b.stepForward(1);
+        if(!b.players[player].isAlive()) return {Position::NONE, false};
+        MemoryArena& arena = MemoryArena::forThread();
+        ArenaScope scope(arena);
+        if(!boards.init(arena, 2 * width)) boards.init(2 * width);
+        layers[0] = boards.take(width);
+        layers[1] = boards.take(width);
+        layers[0][0] = b;
+        evals[0][0] = 0;
+        accumulated[0][0] = 0;
+        hashes[0][0] = b.stateHash();
+        layerSize[0] = 1;
+        for(int depth = 1; depth <= maxPlies && depth <= MAX_PLIES; depth++) {
+            int from = (depth - 1) % 2;
+            int to = depth % 2;
+            expand(from, to, depth);
+            if(layerSize[to] == 0) break;
+            depthReached = depth;
+            rebuildPlan(to, depth);
+            if(outOfTime()) break;
+        }
+        if(planLength == 0) {
+            // Every line dies. Stand still.
+            return {Position::NONE, false};
+        }
+        cerr << "Beam depth: " << depthReached << endl;
+        return pair<int, bool>(plan[0].dir, plan[0].bomb);
+    }
+};
+
+#endif //HYPERSONIC_BEAMBOT_H
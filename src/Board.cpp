@@ -11,11 +11,9 @@ const int Board::WALL;
 const int Board::INVALID;
 
 
-int Board::playerCount;
-int Board::US;
-int Board::totalBoxes;
-bool Board::hash[Board::TILE_COUNT * Bomb::TIMEOUT];
 PosMap Board::positionMap;
+GridTables Board::grid;
+thread_local PathCache Board::paths;
 
 PosMap::PosMap() {
     for(int i = 0; i < Board::TILE_COUNT; i++) {
@@ -23,3 +21,17 @@ PosMap::PosMap() {
     }
 }
 
+
+GridTables::GridTables() {
+    for(int t = 0; t < Board::TILE_COUNT; t++) {
+        int count = 0;
+        if(t % Board::WIDTH != 0) neighbours[t][count++] = t - 1;
+        if(t % Board::WIDTH != Board::WIDTH - 1) neighbours[t][count++] = t + 1;
+        if(t >= Board::WIDTH) neighbours[t][count++] = t - Board::WIDTH;
+        if(t < Board::WIDTH * (Board::HEIGHT - 1)) neighbours[t][count++] = t + Board::WIDTH;
+        neighbourCount[t] = count;
+        for(int u = 0; u < Board::TILE_COUNT; u++) {
+            manhattan[t][u] = abs(t % Board::WIDTH - u % Board::WIDTH) + abs(t / Board::WIDTH - u / Board::WIDTH);
+        }
+    }
+}
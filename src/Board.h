@@ -9,7 +9,10 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <cstdint>
+#include <bitset>
 #include "Position.h"
+#include "Sweep.h"
 
 using std::vector;
 using std::priority_queue;
@@ -19,13 +22,15 @@ using std::list;
 using std::queue;
 
 
+// Narrow fields, as players are copied with every simulated board.
 struct Player {
-    static const int DEAD = -1;
-    int tile;
-    int range;
-    int totalBombs;
-    int bombsAvailable;
-    int boxesDestroyed;
+    static const int DEAD = 255;
+    uint8_t tile;
+    uint8_t range;
+    uint8_t totalBombs;
+    // Signed: the simulations don't all check a bomb is available before placing one.
+    int8_t bombsAvailable;
+    uint8_t boxesDestroyed;
 
     Player() : tile(DEAD), boxesDestroyed(0) {}
 
@@ -48,18 +53,19 @@ struct PowerUp {
     PowerUp(int tile, int type) : tile(tile), type(type) {}
 };
 
+// Four bytes. The explode turn is absolute, so it needs more than the other fields.
 struct Bomb {
     static const int TIMEOUT = 8;
-    int tile;
-    int blastLength;
-    int explodeTurn;
-    int owner;
-    static const int NOT_LIVE = -1;
+    static const int NOT_LIVE = 0xFFFF;
+    uint8_t tile;
+    uint8_t blastLength : 4;
+    uint8_t owner : 4;
+    uint16_t explodeTurn;
 
     Bomb() : explodeTurn(NOT_LIVE) {}
 
     Bomb(int tile, int blastLength, int owner, int turn) :
-            tile(tile), blastLength(blastLength), explodeTurn(turn), owner(owner) {}
+            tile(tile), blastLength(blastLength), owner(owner), explodeTurn(turn) {}
 
     bool isLive() {
         return explodeTurn != NOT_LIVE;
@@ -95,6 +101,40 @@ struct PosMap {
     PosMap();
 };
 
+// Lookups for the fixed grid, built once at startup. Sized like PosMap, as Board isn't complete yet.
+struct GridTables {
+    static const int TILES = 13 * 11;
+    // Neighbours in the order left, right, up, down; only the first neighbourCount are valid.
+    int neighbours[TILES][4];
+    int neighbourCount[TILES];
+    unsigned char manhattan[TILES][TILES];
+    GridTables();
+};
+
+class Board;
+
+/* Shortest path lengths around the blocking tiles (walls, boxes and bombs), cached per source tile.
+ * The cache is only dropped when the layout of blocking tiles changes, which is rare compared to the number of
+ * queries: boxes being destroyed and bombs being placed or exploding.
+ **/
+class PathCache {
+public:
+    static const int TILES = GridTables::TILES;
+    static const unsigned char UNREACHABLE = 255;
+
+    // -1 if to can't be reached.
+    int dist(const Board& b, int from, int to);
+
+private:
+    static const int LAYOUT_WORDS = (TILES + 63) / 64;
+    uint64_t layout[LAYOUT_WORDS] = {0};
+    bool computed[TILES] = {false};
+    unsigned char d[TILES][TILES];
+
+    void refresh(const Board& b);
+    void search(const Board& b, int from);
+};
+
 class Board {
 public:
     static const int WIDTH = 13;
@@ -117,33 +157,72 @@ public:
     static const int INVALID = 'Z';
     static const int INVALID_TILE = -1;
 
-    int aliveCount;
-    static int playerCount;
-    static int US;
-    static int totalBoxes;
-    int turn;
-    char tiles[TILE_COUNT];
-//    int explodeTurn[TILE_COUNT] = {0};
-//    list<Bomb> bombs;
-    bool explodeM[Bomb::TIMEOUT][TILE_COUNT];// = {0};
-    int scoresM[Bomb::TIMEOUT][MAX_PLAYERS];// = {0};
-    // Set these to char? Faster to copy? uint8_t?
-//    int explodeOwner[TILE_COUNT];
-//    int explodeRange[TILE_COUNT];
-    // Unsafe to pickup item (for survival estimate)
-    bool unsafe[TILE_COUNT]; // Bit manipulation with 10 ints?
-    static bool hash[TILE_COUNT * Bomb::TIMEOUT];
+    // Read only once built, so shared by every game in the process.
     static PosMap positionMap;
-//    Bomb bombs[TILE_COUNT];
-//    list<int> bombList;
-//    priority_queue<Explosion, vector<Explosion>, ExplosionComparator> explodeQueue;
-    Player players[MAX_PLAYERS];
+    static GridTables grid;
+    // A cache, so one per thread.
+    static thread_local PathCache paths;
     static const int MAX_BOMB_COUNT = MAX_PLAYERS * (Bomb::TIMEOUT - 1);
+
+    // Hot fields first: every simulated step reads the tiles and players.
+    char tiles[TILE_COUNT];
+    Player players[MAX_PLAYERS];
+    int turn;
+    uint8_t aliveCount;
+    uint8_t bombCount = 0;
+    // Unordered. bombSlots buckets them by explode turn instead.
     Bomb bombs[MAX_BOMB_COUNT];
-    int bombCount = 0;
+    // Bit i of bombSlots[s] is set when bombs[i] explodes in timeline slot s (see ringSlot).
+    uint32_t bombSlots[Bomb::TIMEOUT] = {0};
+    // Unsafe to pickup item (for survival estimate)
+    std::bitset<TILE_COUNT> unsafe;
+    // The game's: players at the start, which of them we are, and the boxes on the first turn.
+    int playerCount = 0;
+    int US = 0;
+    int totalBoxes = 0;
+    // Timelines as ring buffers, indexed through explodes(k) and scores(k): k turns from now.
+    uint8_t scoresRing[Bomb::TIMEOUT][MAX_PLAYERS];
+    bool explodeRing[Bomb::TIMEOUT][TILE_COUNT];
 
     Board() {}
 
+    static_assert((Bomb::TIMEOUT & (Bomb::TIMEOUT - 1)) == 0, "ringSlot masks by Bomb::TIMEOUT - 1");
+    // Slot of the timelines for k turns from now. Stepping forward only moves the start.
+    inline int ringSlot(int k) const {
+        return (turn + k) & (Bomb::TIMEOUT - 1);
+    }
+
+    inline bool* explodes(int k) {
+        return explodeRing[ringSlot(k)];
+    }
+
+    inline const bool* explodes(int k) const {
+        return explodeRing[ringSlot(k)];
+    }
+
+    inline uint8_t* scores(int k) {
+        return scoresRing[ringSlot(k)];
+    }
+
+    inline const uint8_t* scores(int k) const {
+        return scoresRing[ringSlot(k)];
+    }
+
+    void clearTimeline() {
+        memset(explodeRing, 0, sizeof(explodeRing));
+        memset(scoresRing, 0, sizeof(scoresRing));
+    }
+
+    void clearBombs() {
+        bombCount = 0;
+        memset(bombSlots, 0, sizeof(bombSlots));
+    }
+
+    // Timeline slot of the turn a bomb explodes on (explodeTurn is the turn after its explosion is processed).
+    static inline int bombSlot(const Bomb& b) {
+        return (b.explodeTurn - 1) & (Bomb::TIMEOUT - 1);
+    }
+
     char& operator()(int y, int x) {
         return tiles[x + y*WIDTH];
     }
@@ -184,7 +263,7 @@ public:
     }
 
     static inline int dist(int a, int b) {
-        return abs(a % WIDTH - b % WIDTH) + abs(a / WIDTH - b / WIDTH);
+        return grid.manhattan[a][b];
     }
 
 
@@ -196,85 +275,9 @@ public:
         return x + WIDTH * y;
     }
 
-    inline vector<int> neighbours(int p) const  {
-        vector<int> ans;
-        if(p % WIDTH != 0) {
-            ans.push_back(p - 1);
-        }
-        if(p % WIDTH != WIDTH - 1) {
-            ans.push_back(p + 1);
-        }
-        if(p >= WIDTH) {
-            ans.push_back(p - WIDTH);
-        }
-        if(p < WIDTH * (HEIGHT - 1)) {
-            ans.push_back(p + WIDTH);
-        }
-        return ans;
-    }
-
-void neighbours(int t, int* ans, int* count) const {
-    (*count) = 0;
-    if(t % WIDTH != 0) {
-        ans[(*count)++] = (t - 1);
-    }
-    if(t % WIDTH != WIDTH - 1) {
-        ans[(*count)++] = (t + 1);
-    }
-    if(t >= WIDTH) {
-        ans[(*count)++] = (t - WIDTH);
-    }
-    if(t < WIDTH * (HEIGHT - 1)) {
-        ans[(*count)++] = (t + WIDTH);
-    }
-}
-
-    vector<int> neighboursInc(int p) const {
-        vector<int> ans;
-        ans.push_back(p);
-        if(p % WIDTH != 0) {
-            ans.push_back(p - 1);
-        }
-        if(p % WIDTH != WIDTH - 1) {
-            ans.push_back(p + 1);
-        }
-        if(p >= WIDTH) {
-            ans.push_back(p - WIDTH);
-        }
-        if(p < WIDTH * (HEIGHT - 1)) {
-            ans.push_back(p + WIDTH);
-        }
-        return ans;
-    }
-
-
-    inline vector<Position> neighbours(const Position& pos) const {
-        vector<Position> ans;
-        if(pos.y > 0) {
-            ans.push_back(Position(pos.y-1, pos.x));
-        }
-        if(pos. y < HEIGHT - 1) {
-            ans.push_back(Position(pos.y+1, pos.x));
-        }
-        if(pos.x > 0) {
-            ans.push_back(Position(pos.y, pos.x - 1));
-        }
-        if(pos.x < WIDTH - 1) {
-            ans.push_back(Position(pos.y, pos.x + 1));
-        }
-        return ans;
-    }
-
-    inline vector<int> freeNeighbours(int tile) const {
-        vector<int> all = neighbours(tile);
-        for(auto it  = all.begin(); it != all.end();) {
-            if(!isFree(*it)) {
-                it = all.erase(it);
-            } else {
-                ++it;
-            }
-        }
-        return all;
+    void neighbours(int t, int* ans, int* count) const {
+        *count = grid.neighbourCount[t];
+        memcpy(ans, grid.neighbours[t], sizeof(grid.neighbours[t]));
     }
 
 
@@ -335,7 +338,7 @@ void neighbours(int t, int* ans, int* count) const {
             unsafe[next] = false;
             int min = -1;
             for(int i = 0; i < Bomb::TIMEOUT; i++) {
-                if(explodeM[i][next]) {
+                if(explodes(i)[next]) {
                     min = i;
                     break;
                 }
@@ -367,45 +370,28 @@ void neighbours(int t, int* ans, int* count) const {
         }
     }*/
 
-    int pathDist(int from, int to) const {
-        int dist = -1;
-        unordered_set<int> seen;
-        queue<int> queue;
-        queue.push(from);
-        while(!queue.empty()) {
-            int size = queue.size();
-            dist++;
-            for(int i = 0; i < size; i++) {
-                int t = queue.front();
-                queue.pop();
-                if(seen.count(t)) continue;
-                seen.insert(t);
-                if(t == to) return dist;
-                for(auto n : freeNeighbours(t)) {
-                    if(!seen.count(n))  queue.push(n);
-                }
-            }
-        }
-        return -1;
-    }
+    // Steps from one tile to another over free tiles, or -1 if there is no path.
+    int pathDist(int from, int to) const;
 
-    // Includes current position.
-    vector<int> reachableFrom(int tile, int steps) {
-        unordered_set<int> seen;
+    // Tiles fewer than steps moves away, in breadth first order. Includes the current position.
+    vector<int> reachableFrom(int tile, int steps) const {
         vector<int> ans;
-        queue<int> queue;
-        queue.push(tile);
-        while(!queue.empty() && steps > 0) {
-            steps--;
-            int size = queue.size();
-            for(int i = 0; i < size; i++) {
-                int t = queue.front();
-                queue.pop();
-                if(seen.count(t)) continue;
-                seen.insert(t);
+        int queue[TILE_COUNT];
+        bool seen[TILE_COUNT] = {false};
+        int qIn = 0;
+        int qOut = 0;
+        queue[qIn++] = tile;
+        seen[tile] = true;
+        for(; steps > 0 && qOut < qIn; steps--) {
+            int levelEnd = qIn;
+            while(qOut < levelEnd) {
+                int t = queue[qOut++];
                 ans.push_back(t);
-                for(auto n : freeNeighbours(t)) {
-                    queue.push(n);
+                for(int i = 0; i < grid.neighbourCount[t]; i++) {
+                    int n = grid.neighbours[t][i];
+                    if(seen[n] || !isFree(n)) continue;
+                    seen[n] = true;
+                    queue[qIn++] = n;
                 }
             }
         }
@@ -413,6 +399,28 @@ void neighbours(int t, int* ans, int* count) const {
     }
 
 
+    // FNV-1a over the tiles, players and bombs. These determine the explosion timeline, so equal hashes can be
+    // treated as duplicate states by the searches. Bombs are mixed in commutatively as their order isn't fixed.
+    uint64_t stateHash() const {
+        static const uint64_t FNV_PRIME = 1099511628211ULL;
+        uint64_t h = 14695981039346656037ULL;
+        for(int i = 0; i < TILE_COUNT; i++) {
+            h = (h ^ (unsigned char) tiles[i]) * FNV_PRIME;
+        }
+        for(int p = 0; p < MAX_PLAYERS; p++) {
+            h = (h ^ (unsigned) (players[p].tile + 1)) * FNV_PRIME;
+            h = (h ^ (unsigned) players[p].range) * FNV_PRIME;
+            h = (h ^ (unsigned) players[p].bombsAvailable) * FNV_PRIME;
+        }
+        uint64_t bombMix = 0;
+        for(int i = 0; i < bombCount; i++) {
+            uint64_t b = (uint64_t) bombs[i].tile | (uint64_t) (bombs[i].explodeTurn - turn) << 8
+                         | (uint64_t) bombs[i].blastLength << 12 | (uint64_t) bombs[i].owner << 20;
+            bombMix += (b + 0x9E3779B97F4A7C15ULL) * FNV_PRIME;
+        }
+        return h ^ bombMix;
+    }
+
     int nextBombTurn() {
         return turn + Bomb::TIMEOUT;
     }
@@ -428,7 +436,7 @@ void neighbours(int t, int* ans, int* count) const {
         *(max) = 0;
         *(min) = 0;
         for(int i = 0; i < Bomb::TIMEOUT; i++) {
-            if(explodeM[i][tile]) {
+            if(explodes(i)[tile]) {
                 (*count)++;
                 *max = i;
                 if(!seen) *min = i;
@@ -440,7 +448,7 @@ void neighbours(int t, int* ans, int* count) const {
     int earliestExp(int tile) const {
         int min = -1;
         for(int i = 0; i < Bomb::TIMEOUT; i++) {
-            if(explodeM[i][tile]) {
+            if(explodes(i)[tile]) {
                 min = i;
                 break;
             }
@@ -451,6 +459,8 @@ void neighbours(int t, int* ans, int* count) const {
 
 
     void placeBombOnly(int player, int placedAt, int timeout, int blastLength) {
+        // Bomb::blastLength has 4 bits. Nothing longer than a row makes a difference.
+        if(blastLength > WIDTH - 1) blastLength = WIDTH - 1;
         int turnsBefore; // used later
         int turnsBeforeInc;
         int min;
@@ -459,10 +469,11 @@ void neighbours(int t, int* ans, int* count) const {
         minMaxCount(placedAt, &min, &max, &count);
 //        int expAt = count == 0 ? turn + timeout : std::min(turn + timeout, min);
         int relExpAt = count == 0 ? timeout - 1 : std::min(timeout- 1, min);
-        // Add to bomb list (unordered)
+        // Add to bomb list (unordered), and to the bucket of its explode turn.
 //        bombs.push_back(Bomb(placedAt, blastLength, player, relExpAt + turn + 1));
+        bombSlots[ringSlot(relExpAt)] |= 1u << bombCount;
         bombs[bombCount++] = Bomb(placedAt, blastLength, player, relExpAt + turn + 1);
-        explodeM[relExpAt][placedAt] = true;
+        explodes(relExpAt)[placedAt] = true;
         tiles[placedAt] = BOMB;
 //        explodeOwner[placedAt] = player; // Useful?
 //        explodeRange[t] = blastLength;
@@ -477,7 +488,7 @@ void neighbours(int t, int* ans, int* count) const {
                 if (max <= relExpAt) { // Equal okay?
                     // All explosions here are earlier, or there are none.
                     // All easy in this case.
-                    explodeM[relExpAt][t] = true;
+                    explodes(relExpAt)[t] = true;
                     // Empty tiles have no processing.
                     if (tiles[t] == EMPTY) {
                         continue;
@@ -486,7 +497,7 @@ void neighbours(int t, int* ans, int* count) const {
                     turnsBeforeInc = count;
                     turnsBefore = count == 0 ? 0 : relExpAt == max ? count -1 : count;
                     if(isBox(t) && turnsBeforeInc == 0) {
-                        scoresM[relExpAt][player]++;
+                        scores(relExpAt)[player]++;
                     }
                     // Moving to this square causes unpredictable blasts.
                     if(isPowerUp(t) && turnsBefore == 0) {
@@ -510,7 +521,7 @@ void neighbours(int t, int* ans, int* count) const {
                         // Empty tiles, or empty boxes, powerup or bombs which have already been destroyed, thus
                         // handled before.
                         // Already done, above.
-                        explodeM[relExpAt][t] = true;
+                        explodes(relExpAt)[t] = true;
 //                        explodeM[relExpAt][t] = true;
                     } else  {
                         // We have hit a bomb, box or item which has a later explosion. Later explosions will no
@@ -524,81 +535,38 @@ void neighbours(int t, int* ans, int* count) const {
         }
     }
 
-    void sortBombs() {
-        if(bombCount == 0) return;
-        if(bombCount < 20) {
-            insertionSort();
-        } else {
-            // Quicksort
-            shuffleBombs();
-            sort(bombs, 0, bombCount - 1);
+    // Removes bombs[i] by moving the last bomb into its place.
+    void removeBomb(int i) {
+        int last = --bombCount;
+        bombSlots[bombSlot(bombs[i])] &= ~(1u << i);
+        if(i != last) {
+            bombs[i] = bombs[last];
+            uint32_t& slot = bombSlots[bombSlot(bombs[i])];
+            slot = (slot & ~(1u << last)) | (1u << i);
         }
     }
 
-    void insertionSort() {
-        Bomb temp;
-        for(int i = 1; i < bombCount; i++) {
-            for(int j = i; j > 0 && bombs[j].explodeTurn < bombs[j-1].explodeTurn; j--) {
-                temp = bombs[j];
-                bombs[j] =bombs[j-1];
-                bombs[j-1] = temp;
+    // Takes the bombs exploding from fromTurn on off the board, clears that part of the timeline, and places them
+    // again, earliest first.
+    void rebomb(int fromTurn) {
+        int relTurn = fromTurn - turn;
+        Bomb later[MAX_BOMB_COUNT];
+        int laterCount = 0;
+        for(int k = relTurn; k < Bomb::TIMEOUT; k++) {
+            const uint32_t& slot = bombSlots[ringSlot(k)];
+            while(slot) {
+                int i = __builtin_ctz(slot);
+                later[laterCount++] = bombs[i];
+                removeBomb(i);
             }
+            std::memset(explodes(k), 0, sizeof(explodeRing[0]));
+            std::memset(scores(k), 0, sizeof(scoresRing[0]));
         }
-    }
-
-    void sort(Bomb bombs[], int lo, int hi) {
-        if(hi <= lo) return;
-        int j = partition(bombs, lo, hi);
-        sort(bombs, lo, j-1);
-        sort(bombs, j+1, hi);
-    }
-
-    int partition(Bomb bombs[], int lo, int hi) {
-        int i = lo;
-        int j = hi+1;
-        Bomb temp;
-        while(i <= j) {
-            while(bombs[++i].explodeTurn <= bombs[lo].explodeTurn) if(i == hi) break;
-            while(bombs[--j].explodeTurn >= bombs[lo].explodeTurn) if(j == lo) break;
-            if(i >= j) break;
-            temp = bombs[i];
-            bombs[i] = bombs[j];
-            bombs[j] = temp;
+        for(int j = 0; j < laterCount; j++) {
+            placeBombOnly(later[j].owner, later[j].tile, later[j].explodeTurn - turn, later[j].blastLength);
         }
-        temp = bombs[j];
-        bombs[j] = bombs[lo];
-        bombs[lo] = temp;
-        return j;
     }
 
-    void shuffleBombs() {
-        int idx;
-        Bomb temp;
-        for(int i = 0; i < bombCount; i++) {
-            idx = i + rand() % (bombCount - i);
-            temp = bombs[idx];
-            bombs[idx] = bombs[i];
-            bombs[i] = temp;
-        }
-    }
-
-        void rebomb(int fromTurn) {
-            // extra -1? hmmm
-            int relTurn = fromTurn - turn;
-            int turnsToDelete = Bomb::TIMEOUT - relTurn;
-            std::memset(explodeM + relTurn, 0, sizeof(bool) * turnsToDelete * TILE_COUNT);
-            std::memset(scoresM + relTurn, 0, sizeof(int) * turnsToDelete * MAX_PLAYERS);
-            // Sort bombs
-            sortBombs();
-            int i = bombCount - 1;
-            for (; i >= 0 && bombs[i].explodeTurn >= relTurn; i--);
-            int oldBombCount = bombCount;
-            bombCount = i + 1;
-            for (int j = i + 1; j < oldBombCount; j++) {
-                placeBombOnly(bombs[j].owner, bombs[j].tile, bombs[j].explodeTurn - turn, bombs[j].blastLength);
-            }
-        }
-
 //    void rebombOld(int fromTurn) {
 //         extra -1? hmmm
 //        int relTurn = fromTurn - turn;
@@ -695,19 +663,11 @@ void neighbours(int t, int* ans, int* count) const {
 //    }
 
     void stepForward(int steps) {
-//        bombs.sort(CompareCountown());
-        sortBombs();
         for(int t = 0; t < steps; t++) {
             // Engine bug fix.
-            for(int i = 0; i < TILE_COUNT; i++) {
-                if(tiles[i] == BOX_DESTROYED) {
-                    tiles[i] = EMPTY;
-                } else if(tiles[i] == BOMB_RANGE_BOX_DESTROYED) {
-                    tiles[i] = BOMB_RANGE_PU;
-                } else if(tiles[i] == BOMB_COUNT_BOX_DESTROYED) {
-                    tiles[i] = BOMB_COUNT_PU;
-                }
-            }
+            Sweep::settleDestroyed(tiles, TILE_COUNT);
+            // This turn's slot. Once handled and cleared, it is the slot furthest in the future.
+            const int now = ringSlot(0);
             turn++;
 //            auto bombItr = bombs.begin();
 //            while(bombItr != bombs.end() && bombItr->explodeTurn <= turn) {
@@ -715,28 +675,24 @@ void neighbours(int t, int* ans, int* count) const {
 //                players[bombItr->owner].bombsAvailable++;
 //                bombItr = bombs.erase(bombItr);
 //            }
-            int shift = 0;
-            for(; shift < bombCount; shift++) {
-                if(bombs[shift].explodeTurn > turn) break;
-                if(bombs[shift].explodeTurn < turn) throw std::runtime_error("All bombs should have been delt with in previous turn.");
-                players[bombs[shift].owner].bombsAvailable++;
-            }
-            for(int i = shift; i < bombCount; i++) {
-                bombs[i-shift] = bombs[i];
+            // Highest index first, so the bomb moved into a freed place is never one still to be removed.
+            uint32_t expiring = bombSlots[now];
+            while(expiring) {
+                int i = 31 - __builtin_clz(expiring);
+                expiring &= ~(1u << i);
+                players[bombs[i].owner].bombsAvailable++;
+                removeBomb(i);
             }
-            bombCount -= shift;
             for(int p = 0; p < aliveCount; p++) {
-                players[p].boxesDestroyed += scoresM[0][p];
+                players[p].boxesDestroyed += scoresRing[now][p];
             }
-            for(int i = 0; i < TILE_COUNT; i++) {
-                if(explodeM[0][i]) {
-                    explode(i);
-                }
+            int exploding[TILE_COUNT];
+            int explodingCount = Sweep::setIndices(explodeRing[now], TILE_COUNT, exploding);
+            for(int i = 0; i < explodingCount; i++) {
+                explode(exploding[i]);
             }
-            memmove(explodeM, explodeM + 1, (Bomb::TIMEOUT - 1) * sizeof(bool) * TILE_COUNT);
-            memmove(scoresM, scoresM + 1, (Bomb::TIMEOUT - 1) * sizeof(int) * MAX_PLAYERS);
-            memset(explodeM +  (Bomb::TIMEOUT - 1), 0, sizeof(bool) * TILE_COUNT);
-            memset(scoresM + (Bomb::TIMEOUT - 1),  0, sizeof(int) * MAX_PLAYERS);
+            memset(explodeRing[now], 0, sizeof(explodeRing[now]));
+            memset(scoresRing[now], 0, sizeof(scoresRing[now]));
         }
     }
 
@@ -775,11 +731,12 @@ void neighbours(int t, int* ans, int* count) const {
         }
         int startTile = players[player].tile;
 //        unordered_set<int> seen(30);
-        memset(hash, 0, sizeof(hash));
-        return survivalTurns(startTile, max, 1);//, seen);
+        // On the stack rather than shared, so boards on different threads can search at once.
+        bool hash[TILE_COUNT * Bomb::TIMEOUT] = {false};
+        return survivalTurns(startTile, max, 1, hash);//, seen);
     }
 
-    int survivalTurns(int t, int targetDepth, int currentDepth) const {//, unordered_set<int>& seen) const {
+    int survivalTurns(int t, int targetDepth, int currentDepth, bool hash[]) const {//, unordered_set<int>& seen) const {
         if(currentDepth == targetDepth) return currentDepth;
         // Orthogonal (prime) numbers
         static const int P1 = 2;
@@ -811,7 +768,7 @@ void neighbours(int t, int* ans, int* count) const {
 
 
             if(willBeFree(n, currentDepth, i)) {
-                maxTurns = std::max(maxTurns, survivalTurns(n, targetDepth, currentDepth+1));//, seen));
+                maxTurns = std::max(maxTurns, survivalTurns(n, targetDepth, currentDepth+1, hash));//, seen));
                 if(maxTurns == targetDepth) return targetDepth;
             }
         }
@@ -829,8 +786,8 @@ void neighbours(int t, int* ans, int* count) const {
 //                break;
 //            }
 //        }
-        const bool free = isFree(n) && !explodeM[turnsInFuture-1][n] && !unsafe[n] //&& !occupied
-                || tiles[n] == BOMB && moveDir == Position::NONE && !explodeM[turnsInFuture-1][n];
+        const bool free = isFree(n) && !explodes(turnsInFuture-1)[n] && !unsafe[n] //&& !occupied
+                || tiles[n] == BOMB && moveDir == Position::NONE && !explodes(turnsInFuture-1)[n];
         if(free) return true;
 
         // GameEngine bug.
@@ -838,10 +795,10 @@ void neighbours(int t, int* ans, int* count) const {
         int prevExpCount = 0;
         const int until = isB ? turnsInFuture - 2 : turnsInFuture - 1;
         for(int j = 0; j < until; j++) { // -1? or not...
-            if(explodeM[j][n]) prevExpCount++;
+            if(explodes(j)[n]) prevExpCount++;
         }
         // Will be free
-        return (isDestroyedBox(n) && !explodeM[turnsInFuture-1][n]) || (isB && prevExpCount > 0 && !explodeM[turnsInFuture-1][n]) && !unsafe[n];
+        return (isDestroyedBox(n) && !explodes(turnsInFuture-1)[n]) || (isB && prevExpCount > 0 && !explodes(turnsInFuture-1)[n]) && !unsafe[n];
     }
 
     void explode(int tile) {
@@ -920,4 +877,51 @@ void neighbours(int t, int* ans, int* count) const {
 //    }
 };
 
+// Boards are copied for every simulated step, so they should stay small (24 cache lines).
+static_assert(sizeof(Player) == 5, "Player layout has grown");
+static_assert(sizeof(Bomb) == 4, "Bomb layout has grown");
+static_assert(sizeof(Board) <= 24 * 64, "Board layout has grown");
+static_assert(Board::MAX_BOMB_COUNT <= 32, "bombSlots holds a bomb per bit");
+
+inline int Board::pathDist(int from, int to) const {
+    return paths.dist(*this, from, to);
+}
+
+inline void PathCache::refresh(const Board& b) {
+    uint64_t now[LAYOUT_WORDS] = {0};
+    for(int i = 0; i < TILES; i++) {
+        if(!b.isFree(i)) now[i / 64] |= 1ULL << (i % 64);
+    }
+    if(memcmp(now, layout, sizeof(layout)) != 0) {
+        memcpy(layout, now, sizeof(layout));
+        memset(computed, 0, sizeof(computed));
+    }
+}
+
+inline void PathCache::search(const Board& b, int from) {
+    unsigned char* row = d[from];
+    memset(row, UNREACHABLE, TILES);
+    int queue[TILES];
+    int qIn = 0;
+    int qOut = 0;
+    row[from] = 0;
+    queue[qIn++] = from;
+    while(qOut < qIn) {
+        int t = queue[qOut++];
+        for(int i = 0; i < Board::grid.neighbourCount[t]; i++) {
+            int n = Board::grid.neighbours[t][i];
+            if(row[n] != UNREACHABLE || !b.isFree(n)) continue;
+            row[n] = row[t] + 1;
+            queue[qIn++] = n;
+        }
+    }
+    computed[from] = true;
+}
+
+inline int PathCache::dist(const Board& b, int from, int to) {
+    refresh(b);
+    if(!computed[from]) search(b, from);
+    return d[from][to] == UNREACHABLE ? -1 : d[from][to];
+}
+
 #endif //HYPERSONIC_BOARD_H
@@ -1,56 +1,264 @@
 #ifndef HYPERSONIC_ALL_BOT_H_H
 #define HYPERSONIC_ALL_BOT_H_H
 
+#include <atomic>
 #include <cmath>
 #include <limits>
 
 #include "Board.h"
 #include "Mechanics.h"
+#include "Heatmap.h"
+#include "TurnContext.h"
+#include "Territory.h"
+#include "MoveOrdering.h"
+#include "SafeMoves.h"
 #include "AnnealingBot.h"
 
 using namespace std;
 
 template<int MAX_DEPTH>
 class Bot {
-    static constexpr double boxScore = 1;
-    static double depreciationM[16];
-public:
-    static constexpr double boxSF = 1;
-    static constexpr double boxDepreciation = 0.875;
-    static constexpr double powerupSF = 0.1;
-    static constexpr double bombsAvailableSF = 0.125;
-    static constexpr double distSF = 0.1;
-    static constexpr double closestSF = 0.005;
+    // Leaf box counts look up to a bomb timeout past the deepest ply.
+    static const int DEPRECIATION_SIZE = MAX_DEPTH + Bomb::TIMEOUT + 2;
+    // Plain members rather than static constants, so the tuner can set them. The hot path only reads these.
+    BotFactors factors;
+    double depreciationM[DEPRECIATION_SIZE];
+    // The largest depreciation from each depth on, for the bounds.
+    double maxDepreciationM[DEPRECIATION_SIZE];
+    // The bounds assume every weight is a bonus (and closestSF a penalty).
+    bool boundable = true;
+    // Position of each ply's move in the unordered search, so ties are broken as that search broke them (first
+    // found wins) whatever order the moves are tried in.
+    int currentOrder[MAX_DEPTH];
+    int bestOrder[MAX_DEPTH];
+    int bestLength = 0;
+    // The whole best path (best only keeps its first move), our tile at each ply, and whether the path so far is
+    // the ordering's principal variation, for the move ordering.
+    Move bestPath[MAX_DEPTH];
+    int currentTile[MAX_DEPTH];
+    bool followingPV[MAX_DEPTH + 1];
 
+    struct Candidate {
+        Move move;
+        int order;
+        double priority;
+    };
+public:
     Move best[MAX_DEPTH];
     Move current[MAX_DEPTH];
     Move* enemyPreset;
     int enemyMoveCount = 0;
     int enemyPlayer;
+    // Enemies simulated at every ply (after our move), e.g. by a learned OpponentModel.
+    SimBot** enemyAI = NULL;
+    int enemyAICount = 0;
+    // Bomb spot values of the root board, for the leaf evaluation. Optional.
+    const Heatmap* heatmap = NULL;
+    // Facts about the root board, shared by the engines. Optional.
+    const TurnContext* context = NULL;
+    // History, killer and principal variation tables, shared across turns and engines. Optional.
+    MoveOrdering* ordering = NULL;
+    // The root board's territory, for the leaf evaluation (weighted by factors.territorySF). Optional.
+    const Territory* territory = NULL;
     int player;
     double bestScore;
     bool distEnabled = true;
     bool fight = false;
     bool flee = false;
     int fleeFrom = 0;
+    // Branch and bound: cut subtrees whose best possible score can't beat bestScore. Off in fight and flee.
+    bool prune = true;
+    // Try the moves the ordering (then the heatmap) rates first, so good scores (and tight cuts) come early.
+    bool orderMoves = true;
+    long long nodeCount = 0;
+    // Leaves which got as far as the survival search.
+    long long leafCount = 0;
+    // Set from another thread to abandon the search; move() then returns whatever it had. Optional.
+    const atomic<bool>* stop = NULL;
+    // No logging, for self-play, where many games run at once and nobody reads it.
+    bool quiet = false;
+
+    Bot(int player, const BotFactors& factors = defaultBotFactors) : player(player) {
+        setFactors(factors);
+    }
 
-    Bot(int player) : player(player) {}
+    void setFactors(const BotFactors& f) {
+        factors = f;
+        depreciationM[0] = 0;
+        for(int i = 1; i < DEPRECIATION_SIZE; i++) {
+            depreciationM[i] = pow(factors.boxDepreciation, i);
+        }
+        maxDepreciationM[DEPRECIATION_SIZE - 1] = depreciationM[DEPRECIATION_SIZE - 1];
+        for(int i = DEPRECIATION_SIZE - 2; i >= 0; i--) {
+            maxDepreciationM[i] = std::max(depreciationM[i], maxDepreciationM[i + 1]);
+        }
+        boundable = factors.boxSF >= 0 && factors.powerupSF >= 0 && factors.bombsAvailableSF >= 0
+                    && factors.closestSF >= 0 && factors.heatSF >= 0 && factors.territorySF >= 0;
+    }
 
-    void update(double curScore) {
-        if(curScore > bestScore) {
+    const BotFactors& botFactors() const {
+        return factors;
+    }
+
+    // Whether the path of length plies in current came before the best path in the unordered search.
+    bool searchedEarlier(int length) const {
+        int n = std::min(length, bestLength);
+        for(int i = 0; i < n; i++) {
+            if(currentOrder[i] != bestOrder[i]) return currentOrder[i] < bestOrder[i];
+        }
+        return false;
+    }
+
+    void update(double curScore, int length = MAX_DEPTH) {
+        if(curScore > bestScore || (curScore == bestScore && searchedEarlier(length))) {
             // TODO: why sizeof(bestScore)? This isn't copying the whole move.
             memcpy(best, current, sizeof(bestScore));
+            memcpy(bestOrder, currentOrder, sizeof(int) * length);
+            memcpy(bestPath, current, sizeof(Move) * length);
+            bestLength = length;
             bestScore = curScore;
+            if(ordering != NULL) {
+                for(int i = 0; i < length; i++) {
+                    ordering->good(i, currentTile[i], current[i], MAX_DEPTH - i);
+                }
+            }
         }
     }
 
+    bool pruning() const {
+        return prune && boundable && !fight && !flee;
+    }
+
+    // Whether a bound (summed in double, where the search sums in float) can't beat bestScore.
+    bool cut(double bound) const {
+        return bound + 1e-4 * (1 + fabs(bound)) < bestScore;
+    }
+
+    // The territory term of a leaf: the targets we get next to first. Nothing without a territory or a weight.
+    double territoryScore(const Board& b) const {
+        if(territory == NULL || factors.territorySF == 0) return 0;
+        return factors.territorySF * territory->ownedBoxes(b, player);
+    }
+
+    // An upper bound on every leaf below b, which has just been stepped at depth. Each bomb credits at most one box
+    // a direction, and only our live bombs and one new bomb a ply can credit us. At most one power-up can be picked
+    // up a ply, and bombs come back only from those and our live bombs. The survival and box distance terms are
+    // never bonuses, a heatmap value is at most one target a direction, and no leaf owns more than the root's targets.
+    double upperBound(const Board& b, int depth, double curScore) const {
+        const int rem = MAX_DEPTH - depth;
+        const Player& p = b.players[player];
+        int ours = 0;
+        for(int i = 0; i < b.bombCount; i++) {
+            if(b.bombs[i].owner == player) ours++;
+        }
+        int boxes = 4 * (ours + rem);
+        // Boxes only disappear, so the root's count caps it too.
+        if(context != NULL && context->boxCount() < boxes) boxes = context->boxCount();
+        double bound = curScore + factors.boxSF * boxes * maxDepreciationM[depth + 1];
+        bound += factors.powerupSF * (p.totalBombs + p.range + rem) * depreciationM[MAX_DEPTH];
+        bound += factors.bombsAvailableSF * std::min(p.bombsAvailable + ours + rem, p.totalBombs + rem);
+        if(heatmap != NULL) bound += factors.heatSF * 4;
+        if(territory != NULL) bound += factors.territorySF * territory->targetCount();
+        return bound;
+    }
+
+    // Moves from b at ply (0 for the root), in the order the unordered search tried them, then by priority. Moves
+    // into certain death are dropped (they could only score -12000), unless that leaves none.
+    int candidates(const Board& b, int ply, Candidate out[]) const {
+        int n = 0;
+        const Player& p = b.players[player];
+        int doomed = SafeMoves::legal(b, player) & ~SafeMoves::survivable(b, player, 1);
+        // A second pass without the filter if it left nothing.
+        for(int pass = 0; pass < 2 && n == 0; pass++) {
+            if(pass == 1) doomed = 0;
+            int order = 0;
+            for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+                if(!b.canMove(player, d)) continue;
+                if(ply == 0) {
+                    if(!(doomed & SafeMoves::bit(d, false))) out[n++] = {Move(d, false), order, 0};
+                    order++;
+                    if(p.bombsAvailable && !flee) {
+                        if(!(doomed & SafeMoves::bit(d, true))) out[n++] = {Move(d, true), order, 0};
+                        order++;
+                    }
+                } else {
+                    if(p.bombsAvailable && !b.tiles[p.tile] != Board::BOMB) {
+                        if(!(doomed & SafeMoves::bit(d, true))) out[n++] = {Move(d, true), order, 0};
+                        order++;
+                    }
+                    if(!(doomed & SafeMoves::bit(d, false))) out[n++] = {Move(d, false), order, 0};
+                    order++;
+                }
+            }
+        }
+        if(!orderMoves || (heatmap == NULL && ordering == NULL)) return n;
+        int range = p.range;
+        for(int i = 0; i < n; i++) {
+            double heat = 0;
+            if(heatmap != NULL) {
+                heat = heatmap->value(range, Board::adjTile(p.tile, out[i].move.dir));
+                if(out[i].move.bomb) heat += heatmap->value(range, p.tile);
+            }
+            // The ordering decides, heat (at most eight targets) breaks its ties.
+            double rank = ordering != NULL ? ordering->priority(ply, p.tile, out[i].move, followingPV[ply]) : 0;
+            out[i].priority = rank * 16 + heat;
+        }
+        // Insertion sort, stable, on at most ten moves.
+        for(int i = 1; i < n; i++) {
+            Candidate c = out[i];
+            int j = i;
+            for(; j > 0 && out[j - 1].priority < c.priority; j--) {
+                out[j] = out[j - 1];
+            }
+            out[j] = c;
+        }
+        return n;
+    }
+
     void setEnemy(int player, Move* moves, int moveCount) {
         enemyPlayer = player;
         enemyPreset = moves;
         enemyMoveCount = moveCount;
     }
 
+    void setHeatmap(const Heatmap* h) {
+        heatmap = h;
+    }
+
+    void setContext(const TurnContext* c) {
+        context = c;
+    }
+
+    void setOrdering(MoveOrdering* o) {
+        ordering = o;
+    }
+
+    void setTerritory(const Territory* t) {
+        territory = t;
+    }
+
+    void setEnemyAI(SimBot* enemies[], int count) {
+        enemyAI = enemies;
+        enemyAICount = count;
+    }
+
+    void moveEnemies(Board& b) {
+        for(int i = 0; i < enemyAICount; i++) {
+            int e = enemyAI[i]->player();
+            if(!b.players[e].isAlive()) continue;
+            Move m = enemyAI[i]->move(b);
+            if(m.bomb && b.players[e].bombsAvailable > 0 && b.tiles[b.players[e].tile] != Board::BOMB) {
+                b.placeBomb(e);
+            }
+            if(b.canMove(e, m.dir)) {
+                b.move(e, m.dir);
+            }
+        }
+    }
+
     void score(Board b, int depth, float curScore) {
+        if(stop != NULL && stop->load(memory_order_relaxed)) return;
+        nodeCount++;
         if(current[depth-1].bomb) {
             b.placeBomb(player);
             if(depth == 1 && !flee) {
@@ -63,6 +271,7 @@ public:
             }
         }
         b.move(player, current[depth-1].dir);
+        moveEnemies(b);
 //        if(enemyMoveCount >= depth) {
 //            if(enemyPreset[depth-1].bomb) {
 //                b.placeBomb(enemyPlayer);
@@ -72,7 +281,7 @@ public:
         int beforeBoxCount = b.players[player].boxesDestroyed;
         b.stepForward(1);
         if(!b.players[player].isAlive()) {
-            update(-12000);
+            update(-12000, depth);
             return;
         }
 //        bool occupied = false;
@@ -87,8 +296,21 @@ public:
 //            curScore -= 100 * (MAX_DEPTH - depth + 1);
 //        }
         int afterBoxCount = b.players[player].boxesDestroyed;
-        curScore += boxSF * (afterBoxCount - beforeBoxCount) * depreciationM[depth];
+        curScore += factors.boxSF * (afterBoxCount - beforeBoxCount) * depreciationM[depth];
         if(depth == MAX_DEPTH) {
+            const double territoryTerm = flee || fight ? 0 : territoryScore(b);
+            if(pruning()) {
+                // Every term but survival and box distance is cheap and exact; those two can only lower it.
+                const Player& p = b.players[player];
+                double bound = curScore + factors.powerupSF * (p.totalBombs + p.range) * depreciationM[depth]
+                               + factors.bombsAvailableSF * p.bombsAvailable;
+                for(int i = 0; i < Bomb::TIMEOUT; i++) {
+                    bound += factors.boxSF * b.scores(i)[player] * depreciationM[depth + i + 1];
+                }
+                if(heatmap != NULL) bound += factors.heatSF * heatmap->value(p.range, p.tile);
+                if(cut(bound + territoryTerm)) return;
+            }
+            leafCount++;
             const int max = 8;
             int turnsLeftAlive = b.survivalTurns(player, max);
             if(turnsLeftAlive < max) {
@@ -108,20 +330,23 @@ public:
                 update(curScore + score);
                 return;
             }
-            curScore += powerupSF * b.players[player].totalBombs * depreciationM[depth];
-            curScore += powerupSF * b.players[player].range * depreciationM[depth];
-            curScore += bombsAvailableSF * b.players[player].bombsAvailable;
+            curScore += factors.powerupSF * b.players[player].totalBombs * depreciationM[depth];
+            curScore += factors.powerupSF * b.players[player].range * depreciationM[depth];
+            curScore += factors.bombsAvailableSF * b.players[player].bombsAvailable;
             for(int i = 0; i < Bomb::TIMEOUT; i++) {
-                curScore += boxSF * b.scoresM[i][player] * depreciationM[boxDepreciation, depth + i + 1]; // i + 1?
+                curScore += factors.boxSF * b.scores(i)[player] * depreciationM[depth + i + 1]; // i + 1?
             }
 
             if(distEnabled) {
-                int boxDist = BoardStats::stepsToClosestBox(b, player);
+                int boxDist = BoardStats::stepsToClosestBox(b, player, context);
                 if (boxDist != -1) {
-                    curScore -= closestSF * boxDist;
+                    curScore -= factors.closestSF * boxDist;
                 }
             }
-            update(curScore);
+            if(heatmap != NULL) {
+                curScore += factors.heatSF * heatmap->value(b.players[player].range, b.players[player].tile);
+            }
+            update(curScore + territoryTerm);
 //            int rem = BoardStats::remainingBoxes(b);
 //            if(BoardStats::closestPlayerDist(b, player) <= 2) {
 //                curScore *= 0.95;
@@ -137,15 +362,15 @@ public:
 //                curScore += closestSF * BoardStats::closestCount(b, player);
 //            }
         } else {
-            for(int d = Position::RIGHT; d <= Position::NONE; d++) {
-                if(!b.canMove(player, d)) continue;
-                bool occupied = false;
-                current[depth+1-1].dir = d;
-                if(b.players[player].bombsAvailable && !b.tiles[b.players[player].tile] != Board::BOMB) {
-                    current[depth+1-1].bomb = true;
-                    score(b, depth + 1, curScore);
-                }
-                current[depth+1-1].bomb = false;
+            if(pruning() && cut(upperBound(b, depth, curScore))) return;
+            Candidate moves[Position::DIR_COUNT * 2];
+            int n = candidates(b, depth, moves);
+            currentTile[depth] = b.players[player].tile;
+            for(int i = 0; i < n; i++) {
+                current[depth] = moves[i].move;
+                currentOrder[depth] = moves[i].order;
+                followingPV[depth + 1] = followingPV[depth] && ordering != NULL
+                                         && ordering->onPV(depth, moves[i].move);
                 score(b, depth + 1, curScore);
             }
         }
@@ -153,21 +378,23 @@ public:
 
     pair<int,bool> move(Board b) {
         bestScore = -std::numeric_limits<double>::infinity();
+        bestLength = 0;
+        nodeCount = 0;
+        leafCount = 0;
         b.stepForward(1);
         if(!b.players[player].isAlive()) return {0, 0};
-        int maxDir = -1;
-        bool bomb = false;
-        for (int d = Position::RIGHT; d <= Position::NONE; d++) {
-            if (!b.canMove(player, d)) continue;
-            current[0].dir = d;
-            current[0].bomb = false;
+        followingPV[0] = true;
+        Candidate moves[Position::DIR_COUNT * 2];
+        int n = candidates(b, 0, moves);
+        currentTile[0] = b.players[player].tile;
+        for(int i = 0; i < n; i++) {
+            current[0] = moves[i].move;
+            currentOrder[0] = moves[i].order;
+            followingPV[1] = ordering != NULL && ordering->onPV(0, moves[i].move);
             score(b, 1, 0);
-            if (b.players[player].bombsAvailable && !flee) {
-                current[0].bomb = true;
-                score(b, 1, 0);
-            }
         }
-        cerr << "Score: " << bestScore << endl;
+        if(ordering != NULL) ordering->setPV(bestPath, bestLength);
+        if(!quiet) cerr << "Score: " << bestScore << endl;
         return pair<int, bool>(best[0].dir, best[0].bomb);
     }
 
@@ -181,23 +408,4 @@ public:
     };
 };
 
-template<int MAX_DEPTH>
-double Bot<MAX_DEPTH>::depreciationM[16] = {
-        0,
-        Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation,
-        Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation * Bot::boxDepreciation
-};
     #endif //HYPERSONIC_ALL_BOT_H_H
@@ -0,0 +1,369 @@
+#ifndef HYPERSONIC_ENDGAMEBOT_H
+#define HYPERSONIC_ENDGAMEBOT_H
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "Board.h"
+#include "SafeMoves.h"
+#include "MemoryArena.h"
+
+using namespace std;
+
+/* Search for boards with no boxes left, where all that matters is who survives.
+ * The board is then little more than the players, their bombs and a few items, so the search can go much deeper
+ * than the general engine. Like ParanoidBot, it is a simultaneous move search with the nearest opponents as a
+ * coalition replying to each of our moves (alpha-beta over our moves and their joint replies), deepened one ply at
+ * a time until the time allocation runs out. Both sides only play moves which survive the step, if they have any.
+ * Nodes are cached in a transposition table keyed on the board up to the map's reflections: a board and its mirror
+ * image share an entry, with the stored move reflected back. A death ends the line, and only the leaves are scored
+ * by how many turns each side can still survive. The boards of the line being searched are a pool taken from the
+ * thread's arena for the move.
+ **/
+class EndgameBot {
+public:
+    static const int MAX_DEPTH = 20;
+    static const int DEFAULT_TIME = 60;
+    static const int UNSET = -1;
+    static const int TABLE_BITS = 18;
+    static constexpr double DEATH_SCORE = -100000;
+    static constexpr double KILL_SCORE = 50000;
+
+    int player;
+    int maxOpponents = 2;
+    int opponentRadius = 10;
+    // A kill is worth going for. Otherwise only surviving counts, and kills are a tie break.
+    bool fight = true;
+    // Stops deepening here, whatever time is left.
+    int maxDepth = MAX_DEPTH;
+    int depthReached = 0;
+    long long nodeCount = 0;
+    long long tableHits = 0;
+    double bestScore = 0;
+
+private:
+    static const int SURVIVAL_TURNS = 8;
+    static const int SYMMETRIES = 4;
+    static const int EXACT = 0;
+    static const int LOWER = 1;
+    static const int UPPER = 2;
+    // Boards in use at each depth: our move, one per opponent's reply, and the step.
+    static const int NODE_SLOTS = Board::MAX_PLAYERS + 1;
+
+    struct Entry {
+        uint64_t key = 0;
+        double value = 0;
+        int8_t depth = -1;
+        int8_t bound = EXACT;
+        int8_t dir = Position::NONE;
+        int8_t bomb = 0;
+    };
+
+    long allocatedTime;
+    long long startTime;
+    bool aborted = false;
+    long long clockChecks = 0;
+    vector<Entry> table;
+    // The reflections the walls allow, as indices into mirror (0 is the identity).
+    int symmetries[SYMMETRIES];
+    int symmetryCount = 0;
+    short mirror[SYMMETRIES][Board::TILE_COUNT];
+    int opponents[Board::MAX_PLAYERS];
+    int opponentCount = 0;
+    ArenaPool<Board> nodes;
+
+    Board& node(int depth, int slot) {
+        return nodes[depth * NODE_SLOTS + slot];
+    }
+
+    long long getTimeMilli() {
+        return chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    bool outOfTime() {
+        if(allocatedTime == UNSET) return false;
+        // Checking the clock is slow compared to a node.
+        if((++clockChecks & 255) == 0 && getTimeMilli() - startTime >= allocatedTime) aborted = true;
+        return aborted;
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Symmetry 1 reflects left to right, 2 top to bottom and 3 both.
+    static int reflect(int tile, int symmetry) {
+        const Position& p = Board::toPosition(tile);
+        int x = symmetry & 1 ? Board::WIDTH - 1 - p.x : p.x;
+        int y = symmetry & 2 ? Board::HEIGHT - 1 - p.y : p.y;
+        return Board::toID(y, x);
+    }
+
+    static int reflectDir(int dir, int symmetry) {
+        if((symmetry & 1) && (dir == Position::LEFT || dir == Position::RIGHT)) return (dir + 2) % 4;
+        if((symmetry & 2) && (dir == Position::UP || dir == Position::DOWN)) return (dir + 2) % 4;
+        return dir;
+    }
+
+    void findSymmetries(const Board& b) {
+        symmetryCount = 0;
+        for(int s = 0; s < SYMMETRIES; s++) {
+            bool holds = true;
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                mirror[s][t] = (short) reflect(t, s);
+                if((b.tiles[t] == Board::WALL) != (b.tiles[mirror[s][t]] == Board::WALL)) holds = false;
+            }
+            if(holds) symmetries[symmetryCount++] = s;
+        }
+    }
+
+    // The board as seen through a reflection. Walls are the same in every allowed one, so they are left out.
+    uint64_t key(const Board& b, int symmetry) const {
+        const short* m = mirror[symmetry];
+        uint64_t h = 0;
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            char c = b.tiles[t];
+            if(c == Board::EMPTY || c == Board::WALL || c == Board::BOMB) continue;
+            h += mix((uint64_t) m[t] << 8 | (unsigned char) c);
+        }
+        for(int i = 0; i < b.bombCount; i++) {
+            const Bomb& bomb = b.bombs[i];
+            h += mix(1ULL << 40 | (uint64_t) m[bomb.tile] | (uint64_t) (bomb.explodeTurn - b.turn) << 8
+                     | (uint64_t) bomb.blastLength << 16 | (uint64_t) bomb.owner << 24);
+        }
+        for(int p = 0; p < b.playerCount; p++) {
+            const Player& pl = b.players[p];
+            uint64_t tile = pl.isAlive() ? m[pl.tile] : 0xFFFF;
+            h = mix(h ^ (tile | (uint64_t) pl.range << 16 | (uint64_t) pl.bombsAvailable << 24
+                         | (uint64_t) p << 32));
+        }
+        return h;
+    }
+
+    // The smallest key over the allowed reflections, and the reflection it came from.
+    uint64_t canonicalKey(const Board& b, int* symmetry) const {
+        uint64_t best = key(b, 0);
+        *symmetry = 0;
+        for(int i = 1; i < symmetryCount; i++) {
+            uint64_t k = key(b, symmetries[i]);
+            if(k < best) {
+                best = k;
+                *symmetry = symmetries[i];
+            }
+        }
+        return best;
+    }
+
+    void chooseOpponents(const Board& b) {
+        opponentCount = 0;
+        pair<int, int> byDist[Board::MAX_PLAYERS];
+        int count = 0;
+        for(int p = 0; p < b.playerCount; p++) {
+            if(p == player || !b.players[p].isAlive()) continue;
+            int d = Board::dist(b.players[p].tile, b.players[player].tile);
+            if(d <= opponentRadius) {
+                byDist[count++] = pair<int, int>(d, p);
+            }
+        }
+        // Insertion sort, nearest first, on at most three opponents.
+        for(int i = 1; i < count; i++) {
+            pair<int, int> o = byDist[i];
+            int j = i;
+            for(; j > 0 && o < byDist[j - 1]; j--) {
+                byDist[j] = byDist[j - 1];
+            }
+            byDist[j] = o;
+        }
+        for(int i = 0; i < count && i < maxOpponents; i++) {
+            opponents[opponentCount++] = byDist[i].second;
+        }
+    }
+
+    static void apply(Board& b, int p, const Move& m) {
+        if(m.bomb) {
+            b.placeBomb(p);
+        }
+        b.move(p, m.dir);
+    }
+
+    // The moves worth trying for p: those which survive the step, or every legal one if none do.
+    static int generate(const Board& b, int p, Move moves[]) {
+        int allowed = SafeMoves::survivable(b, p, 1);
+        if(allowed == 0) allowed = SafeMoves::legal(b, p);
+        if(allowed == 0) allowed = SafeMoves::bit(Position::NONE, false);
+        int count = 0;
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            for(int bomb = 1; bomb >= 0; bomb--) {
+                if(allowed & SafeMoves::bit(d, bomb)) moves[count++] = Move(d, bomb);
+            }
+        }
+        return count;
+    }
+
+    double evaluate(const Board& b) {
+        double score = -1000 * (SURVIVAL_TURNS - b.survivalTurns(player, SURVIVAL_TURNS));
+        for(int i = 0; i < opponentCount; i++) {
+            int o = opponents[i];
+            int enemyTurns = b.players[o].isAlive() ? b.survivalTurns(o, SURVIVAL_TURNS) : 0;
+            score += (fight ? 300 : 30) * (SURVIVAL_TURNS - enemyTurns);
+            if(b.players[o].isAlive()) {
+                int d = Board::dist(b.players[player].tile, b.players[o].tile);
+                score += fight ? -d : d;
+            }
+        }
+        return score + b.players[player].bombsAvailable + b.players[player].range;
+    }
+
+    // After a step: whether the line is over, and its value if so.
+    bool terminal(const Board& b, double* value) {
+        if(!b.players[player].isAlive()) {
+            *value = DEATH_SCORE;
+            return true;
+        }
+        int dead = 0;
+        for(int i = 0; i < opponentCount; i++) {
+            if(!b.players[opponents[i]].isAlive()) dead++;
+        }
+        if(opponentCount > 0 && dead == opponentCount) {
+            *value = (fight ? KILL_SCORE : KILL_SCORE / 10) + evaluate(b);
+            return true;
+        }
+        return false;
+    }
+
+    // Minimises over the joint replies of opponents [idx, opponentCount), with our move applied to b. Replies are
+    // generated on the board before our move, as the opponents can't see it within the turn.
+    double replyValue(const Board& before, const Board& b, int idx, int depth, double alpha, double beta) {
+        if(idx == opponentCount) {
+            Board& next = node(depth, 1 + opponentCount);
+            next = b;
+            next.stepForward(1);
+            nodeCount++;
+            double v;
+            if(terminal(next, &v)) return v;
+            if(depth == 1) return evaluate(next);
+            return value(next, depth - 1, alpha, beta, NULL);
+        }
+        int o = opponents[idx];
+        if(!b.players[o].isAlive()) return replyValue(before, b, idx + 1, depth, alpha, beta);
+        Move moves[SafeMoves::MOVE_KINDS];
+        int count = generate(before, o, moves);
+        double worst = numeric_limits<double>::infinity();
+        for(int i = 0; i < count; i++) {
+            Board& next = node(depth, 1 + idx);
+            next = b;
+            if(moves[i].bomb && !SafeMoves::canBomb(next, o)) continue;
+            if(!next.canMove(o, moves[i].dir)) continue;
+            apply(next, o, moves[i]);
+            worst = min(worst, replyValue(before, next, idx + 1, depth, alpha, beta));
+            if(aborted) return worst;
+            beta = min(beta, worst);
+            if(worst <= alpha) break;
+        }
+        if(worst == numeric_limits<double>::infinity()) {
+            return replyValue(before, b, idx + 1, depth, alpha, beta);
+        }
+        return worst;
+    }
+
+    // The value of b (already stepped) searching depth more turns.
+    double value(const Board& b, int depth, double alpha, double beta, Move* bestMove) {
+        if(outOfTime()) return 0;
+        int symmetry;
+        const uint64_t k = canonicalKey(b, &symmetry);
+        Entry& entry = table[k & (table.size() - 1)];
+        const double alphaIn = alpha;
+        Move hint(Position::NONE, false);
+        bool hasHint = false;
+        if(entry.key == k) {
+            hint = Move(reflectDir(entry.dir, symmetry), entry.bomb);
+            hasHint = true;
+            if(entry.depth >= depth && bestMove == NULL) {
+                if(entry.bound == EXACT
+                   || (entry.bound == LOWER && entry.value >= beta)
+                   || (entry.bound == UPPER && entry.value <= alpha)) {
+                    tableHits++;
+                    return entry.value;
+                }
+            }
+        }
+        Move moves[SafeMoves::MOVE_KINDS];
+        int count = generate(b, player, moves);
+        // The table's move first.
+        for(int i = 0; hasHint && i < count; i++) {
+            if(moves[i].dir == hint.dir && moves[i].bomb == hint.bomb) {
+                swap(moves[0], moves[i]);
+                break;
+            }
+        }
+        double bestValue = -numeric_limits<double>::infinity();
+        Move best = moves[0];
+        for(int i = 0; i < count; i++) {
+            Board& next = node(depth, 0);
+            next = b;
+            apply(next, player, moves[i]);
+            double v = replyValue(b, next, 0, depth, alpha, beta);
+            if(aborted) return bestValue;
+            if(v > bestValue) {
+                bestValue = v;
+                best = moves[i];
+            }
+            alpha = max(alpha, bestValue);
+            if(bestValue >= beta) break;
+        }
+        if(bestMove != NULL) *bestMove = best;
+        entry.key = k;
+        entry.value = bestValue;
+        entry.depth = (int8_t) depth;
+        entry.bound = (int8_t) (bestValue <= alphaIn ? UPPER : bestValue >= beta ? LOWER : EXACT);
+        // Stored as seen from the canonical reflection.
+        entry.dir = (int8_t) reflectDir(best.dir, symmetry);
+        entry.bomb = (int8_t) best.bomb;
+        return bestValue;
+    }
+
+public:
+    EndgameBot(int player, long allocatedTimeMilli = DEFAULT_TIME) :
+            player(player), allocatedTime(allocatedTimeMilli), table(1 << TABLE_BITS) {}
+
+    pair<int, bool> move(Board b) {
+        startTime = getTimeMilli();
+        aborted = false;
+        nodeCount = 0;
+        tableHits = 0;
+        depthReached = 0;
+        fill(table.begin(), table.end(), Entry());
+        b.stepForward(1);
+        if(!b.players[player].isAlive()) return {Position::NONE, false};
+        MemoryArena& arena = MemoryArena::forThread();
+        ArenaScope scope(arena);
+        if(!nodes.init(arena, (MAX_DEPTH + 1) * NODE_SLOTS)) nodes.init((MAX_DEPTH + 1) * NODE_SLOTS);
+        findSymmetries(b);
+        chooseOpponents(b);
+        Move best(Position::NONE, false);
+        bestScore = 0;
+        for(int depth = 1; depth <= maxDepth && depth <= MAX_DEPTH; depth++) {
+            Move m;
+            double v = value(b, depth, -numeric_limits<double>::infinity(), numeric_limits<double>::infinity(), &m);
+            // An unfinished iteration is only as good as the moves it got to, so it is dropped.
+            if(aborted) break;
+            best = m;
+            bestScore = v;
+            depthReached = depth;
+            // The outcome is decided whatever is played.
+            if(v <= DEATH_SCORE || v >= KILL_SCORE / 10) break;
+        }
+        cerr << "Endgame score: " << bestScore << "  depth: " << depthReached << "  nodes: " << nodeCount
+             << "  table hits: " << tableHits << endl;
+        return pair<int, bool>(best.dir, best.bomb);
+    }
+};
+
+#endif //HYPERSONIC_ENDGAMEBOT_H
@@ -0,0 +1,243 @@
+#ifndef HYPERSONIC_EVOLUTIONBOT_H
+#define HYPERSONIC_EVOLUTIONBOT_H
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "Board.h"
+#include "Simulation.h"
+#include "SafeMoves.h"
+
+using namespace std;
+
+/* Replays one plan of the population, repairing moves which aren't legal on the simulated board (walls, bombs
+ * with none available), and moves which are certain death when some other move lives through the next step. The
+ * repair is written back, so the population only carries playable plans.
+ **/
+class RepairingAI : public SimBot {
+    Move* moves;
+    int turn = 0;
+    int player_;
+
+public:
+    RepairingAI(int player, Move moves[], int startFromTurn) :
+            moves(moves), turn(startFromTurn), player_(player) {}
+
+    void setTurn(int fromTurn) {
+        turn = fromTurn;
+    }
+
+    Move move(Board& b) {
+        Move& m = moves[turn++];
+        const int safe = SafeMoves::survivable(b, player_, 1);
+        if(safe != 0) {
+            if(!SafeMoves::allows(safe, m)) m = survivor(safe, m);
+            return m;
+        }
+        // Nothing survives: keep the plan's move where it is playable.
+        if(!b.canMove(player_, m.dir)) {
+            m.dir = Position::NONE;
+        }
+        if(m.bomb && (b.players[player_].bombsAvailable <= 0 || b.tiles[b.players[player_].tile] == Board::BOMB)) {
+            m.bomb = false;
+        }
+        return m;
+    }
+
+    int player() {
+        return player_;
+    }
+
+private:
+    // The surviving move closest to m: its direction with the other bomb choice, else its bomb choice.
+    static Move survivor(int safe, const Move& m) {
+        if(SafeMoves::allows(safe, Move(m.dir, !m.bomb))) return Move(m.dir, !m.bomb);
+        for(int pass = 0; pass < 2; pass++) {
+            const bool bomb = pass == 0 ? m.bomb : !m.bomb;
+            for(int d = Position::NONE; d >= Position::RIGHT; d--) {
+                if(SafeMoves::allows(safe, Move(d, bomb))) return Move(d, bomb);
+            }
+        }
+        return m;
+    }
+};
+
+/* Rolling horizon evolution.
+ * A population of POPULATION plans, each TURNS long, is evolved with tournament selection, one point crossover
+ * and per gene mutation. Plans are scored with the same simulate/score as the AnnealingBot. The population is
+ * kept structure-of-arrays: all genes in one flat array (plan i is genes[i * TURNS, (i + 1) * TURNS)), with the
+ * fitness in a separate array, so a batch of plans can be evaluated by walking contiguous memory. Between turns
+ * every plan is shifted one move to the left, so the search continues from last turn's population.
+ **/
+template<int TURNS, int PLAYERS, int POPULATION = 40>
+class EvolutionBot : public Simulation<TURNS, PLAYERS> {
+    typedef Simulation<TURNS, PLAYERS> Sim;
+    using Sim::player;
+    using Sim::simHistory;
+    using Sim::enemyBots;
+    using Sim::score;
+public:
+    static const int UNSET = -1;
+    static const int ELITES = 2;
+    static const int DEFAULT_GENERATIONS = 30;
+    int generations = 0;
+
+private:
+    static const int TOURNAMENT_SIZE = 2;
+    static constexpr double CROSSOVER_RATE = 0.7;
+    static constexpr double MUTATION_RATE = 1.0 / TURNS;
+
+    long allocatedTime = UNSET;
+    long long startTime;
+    bool hasPrevious = false;
+    Move genes[POPULATION * TURNS];
+    Move offspring[POPULATION * TURNS];
+    double fitness[POPULATION];
+
+    long long getTimeMilli() {
+        return chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    bool outOfTime() {
+        if(allocatedTime == UNSET) return generations >= DEFAULT_GENERATIONS;
+        return getTimeMilli() - startTime >= allocatedTime;
+    }
+
+    static double uniform() {
+        return (double) rand() / RAND_MAX;
+    }
+
+    static Move randomGene() {
+        return Move(rand() % Position::DIR_COUNT, rand() % 2 == 0);
+    }
+
+    void randomPlan(Move plan[]) {
+        for(int i = 0; i < TURNS; i++) {
+            plan[i] = randomGene();
+        }
+    }
+
+    // Higher is better. Plans are repaired as they are played, so every plan is valid.
+    double evaluate(Move plan[]) {
+        RepairingAI ourAI(player, plan, 0);
+        for(int i = 0; i < PLAYERS - 1; i++) {
+            enemyBots[i]->setTurn(0);
+        }
+        Sim::simulate(&ourAI, enemyBots, 0);
+        return score();
+    }
+
+    int tournament() {
+        int best = rand() % POPULATION;
+        for(int i = 1; i < TOURNAMENT_SIZE; i++) {
+            int other = rand() % POPULATION;
+            if(fitness[other] > fitness[best]) best = other;
+        }
+        return best;
+    }
+
+    int fittest() {
+        int best = 0;
+        for(int i = 1; i < POPULATION; i++) {
+            if(fitness[i] > fitness[best]) best = i;
+        }
+        return best;
+    }
+
+    // Elites are copied unchanged. The rest are bred from tournament winners.
+    void breed() {
+        int eliteCount = 0;
+        bool isElite[POPULATION] = {false};
+        double eliteFitness[ELITES];
+        for(; eliteCount < ELITES && eliteCount < POPULATION; eliteCount++) {
+            int best = UNSET;
+            for(int i = 0; i < POPULATION; i++) {
+                if(!isElite[i] && (best == UNSET || fitness[i] > fitness[best])) best = i;
+            }
+            isElite[best] = true;
+            eliteFitness[eliteCount] = fitness[best];
+            memcpy(offspring + eliteCount * TURNS, genes + best * TURNS, TURNS * sizeof(Move));
+        }
+        for(int i = eliteCount; i < POPULATION; i++) {
+            Move* child = offspring + i * TURNS;
+            const Move* mother = genes + tournament() * TURNS;
+            const Move* father = genes + tournament() * TURNS;
+            int cut = uniform() < CROSSOVER_RATE ? 1 + rand() % (TURNS - 1) : TURNS;
+            memcpy(child, mother, cut * sizeof(Move));
+            memcpy(child + cut, father + cut, (TURNS - cut) * sizeof(Move));
+            for(int t = 0; t < TURNS; t++) {
+                if(uniform() < MUTATION_RATE) {
+                    child[t] = randomGene();
+                }
+            }
+        }
+        memcpy(genes, offspring, sizeof(genes));
+        memcpy(fitness, eliteFitness, eliteCount * sizeof(double));
+    }
+
+public:
+    EvolutionBot() {}
+
+    EvolutionBot(int player, long allocatedTimeMilli = UNSET) : Sim(player), allocatedTime(allocatedTimeMilli) {}
+
+    // Evaluates plans [from, to) of the population. The plans are laid out contiguously, so a batch can be handed
+    // to a worker with its own simulation.
+    void evaluateBatch(int from, int to) {
+        for(int i = from; i < to; i++) {
+            fitness[i] = evaluate(genes + i * TURNS);
+        }
+    }
+
+    // Rolling horizon: drop the move just played and append a random one.
+    void shift() {
+        for(int i = 0; i < POPULATION; i++) {
+            Move* plan = genes + i * TURNS;
+            memmove(plan, plan + 1, (TURNS - 1) * sizeof(Move));
+            plan[TURNS - 1] = randomGene();
+        }
+    }
+
+    const Move* plan(int i) const {
+        return genes + i * TURNS;
+    }
+
+    double planFitness(int i) const {
+        return fitness[i];
+    }
+
+    Move move(Board board) {
+        startTime = getTimeMilli();
+        board.stepForward(1);
+        simHistory[0] = board;
+        if(hasPrevious) {
+            shift();
+        } else {
+            for(int i = 0; i < POPULATION; i++) {
+                randomPlan(genes + i * TURNS);
+            }
+        }
+        generations = 0;
+        evaluateBatch(0, POPULATION);
+        while(!outOfTime()) {
+            breed();
+            // Elites are unchanged, so only the offspring need simulating.
+            evaluateBatch(ELITES, POPULATION);
+            generations++;
+        }
+        hasPrevious = true;
+        int best = fittest();
+        cerr << "Generations: " << generations << "  Fitness: " << fitness[best] << endl;
+        return genes[best * TURNS];
+    }
+};
+
+template<int TURNS, int PLAYERS, int POPULATION>
+const int EvolutionBot<TURNS, PLAYERS, POPULATION>::UNSET;
+template<int TURNS, int PLAYERS, int POPULATION>
+const int EvolutionBot<TURNS, PLAYERS, POPULATION>::ELITES;
+template<int TURNS, int PLAYERS, int POPULATION>
+const int EvolutionBot<TURNS, PLAYERS, POPULATION>::DEFAULT_GENERATIONS;
+
+#endif //HYPERSONIC_EVOLUTIONBOT_H
@@ -0,0 +1,129 @@
+#ifndef HYPERSONIC_HEATMAP_H
+#define HYPERSONIC_HEATMAP_H
+
+#include <bitset>
+#include <cstring>
+
+#include "Board.h"
+
+using namespace std;
+
+/* Boxes a bomb on each tile would destroy, for every blast length up to MAX_RANGE.
+ * Only boxes which no bomb is going to destroy yet count (targets), and only targets and walls stop a blast, so
+ * a value matches Mechanics::blastCountAt on the settled board. Built once a turn; when targets are destroyed or
+ * scheduled, only the tiles in line of sight of them are updated. Queries are a table lookup.
+ * The rays out of each tile (up to the first wall or the edge) are tabulated when the heatmap is built, as the
+ * walls never change, so updates walk tile ids rather than positions.
+ **/
+class Heatmap {
+public:
+    static const int MAX_RANGE = Board::WIDTH - 1;
+
+private:
+    unsigned char values[MAX_RANGE + 1][Board::TILE_COUNT];
+    bitset<Board::TILE_COUNT> targets;
+    bitset<Board::TILE_COUNT> walls;
+    // The tiles a blast from each tile passes in each direction, nearest first, before a wall or the edge.
+    unsigned char rays[Board::TILE_COUNT][4][MAX_RANGE];
+    unsigned char rayLengths[Board::TILE_COUNT][4];
+
+    static bool isTarget(const Board& b, int tile) {
+        if(!b.isBox(tile)) return false;
+        for(int i = 0; i < Bomb::TIMEOUT; i++) {
+            if(b.explodes(i)[tile]) return false;
+        }
+        return true;
+    }
+
+    // Counts the target at distance dist for every blast length which reaches it.
+    void add(int tile, int dist, int amount) {
+        for(int r = dist; r <= MAX_RANGE; r++) {
+            values[r][tile] += amount;
+        }
+    }
+
+    // The distance to the first target from tile in direction dir, or 0 if a wall or the edge comes first.
+    int firstTarget(int tile, int dir, int maxDist) const {
+        const unsigned char* ray = rays[tile][dir];
+        const int length = rayLengths[tile][dir] < maxDist ? rayLengths[tile][dir] : maxDist;
+        for(int k = 0; k < length; k++) {
+            if(targets[ray[k]]) return k + 1;
+        }
+        return 0;
+    }
+
+    void buildRays() {
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            const Position& p = Board::toPosition(t);
+            for(int d = Position::RIGHT; d <= Position::UP; d++) {
+                int k = 0;
+                while(k < MAX_RANGE) {
+                    int u = Board::tileAt(p, d, k + 1);
+                    if(u == Board::INVALID_TILE || walls[u]) break;
+                    rays[t][d][k++] = (unsigned char) u;
+                }
+                rayLengths[t][d] = (unsigned char) k;
+            }
+        }
+    }
+
+public:
+    void build(const Board& b) {
+        memset(values, 0, sizeof(values));
+        targets.reset();
+        walls.reset();
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(b.tiles[t] == Board::WALL) walls.set(t);
+            if(isTarget(b, t)) targets.set(t);
+        }
+        buildRays();
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(walls[t]) continue;
+            for(int d = Position::RIGHT; d <= Position::UP; d++) {
+                int k = firstTarget(t, d, MAX_RANGE);
+                if(k > 0) add(t, k, 1);
+            }
+        }
+    }
+
+    // The target at tile has been destroyed, or a bomb will now destroy it. Tiles whose blast stopped at it lose
+    // it, and see through to the next target behind it.
+    void removeTarget(int tile) {
+        if(!targets[tile]) return;
+        targets.reset(tile);
+        for(int d = Position::RIGHT; d <= Position::UP; d++) {
+            int back = (d + 2) % 4;
+            int behind = firstTarget(tile, back, MAX_RANGE);
+            for(int k = 1; k <= rayLengths[tile][d]; k++) {
+                int u = rays[tile][d][k - 1];
+                add(u, k, -1);
+                if(behind > 0 && k + behind <= MAX_RANGE) add(u, k + behind, 1);
+                if(targets[u]) break;
+            }
+        }
+    }
+
+    // Brings the heatmap up to date with a later board of the same game. Targets only ever disappear, so this is
+    // incremental unless the board isn't a successor (then it is rebuilt).
+    void sync(const Board& b) {
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(!targets[t] && isTarget(b, t)) {
+                build(b);
+                return;
+            }
+        }
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(targets[t] && !isTarget(b, t)) removeTarget(t);
+        }
+    }
+
+    int value(int range, int tile) const {
+        return values[range < MAX_RANGE ? range : MAX_RANGE][tile];
+    }
+
+    bool isTarget(int tile) const {
+        return targets[tile];
+    }
+};
+
+#endif //HYPERSONIC_HEATMAP_H
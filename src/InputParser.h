@@ -11,6 +11,9 @@ class InputParser {
     std::istream& stream;
     Board prev;
     int turn = 0;
+    // Read on the first turn, and given to every board after it.
+    int gamePlayers = 0;
+    int gameBoxes = 0;
 
 public:
     int ourID;
@@ -32,13 +35,12 @@ public:
 
     void update(Board& board) {
         board.turn = turn;
-        memset(board.explodeM, 0, sizeof(bool) * Bomb::TIMEOUT * Board::TILE_COUNT);
-        memset(board.scoresM, 0, sizeof(int) * Bomb::TIMEOUT * Board::MAX_PLAYERS);
+        board.clearTimeline();
 //        memset(board.explodeRange, 0, sizeof(board.explodeRange));
 //        memset(board.explodeOwner, 0, sizeof(board.explodeOwner));
-        memset(board.unsafe, 0, sizeof(board.unsafe));
+        board.unsafe.reset();
 //        board.bombs.clear();
-        board.bombCount = 0;
+        board.clearBombs();
         int boxCount = 0;
         for (int i = 0; i < Board::HEIGHT; i++) {
             std::string row;
@@ -57,7 +59,8 @@ public:
         stream >> entities;
         stream.ignore();
         int prevEntityType = 0;
-        vector<Bomb> bombs;
+        Bomb bombs[Board::MAX_BOMB_COUNT];
+        int bombCount = 0;
         for (int i = 0; i < entities; i++) {
             int entityType;
             int owner;
@@ -85,7 +88,10 @@ public:
 //                    throw std::runtime_error("Bomb not at player's position.");
 //                }
                 // Need to deal with bombs after powerups are placed.
-                bombs.push_back(Bomb(tile, param2-1, owner, turn + param1));
+                if(bombCount == Board::MAX_BOMB_COUNT) throw std::runtime_error("Too many bombs.");
+                // Bomb::blastLength has 4 bits. Nothing longer than a row makes a difference.
+                int blastLength = param2 - 1 > Board::WIDTH - 1 ? Board::WIDTH - 1 : param2 - 1;
+                bombs[bombCount++] = Bomb(tile, blastLength, owner, turn + param1);
 //                board.placeBombOnly(owner, tile, param1, param2-1);
 //                board.players[owner].totalBombs++;
             } else if(entityType == 2) {
@@ -100,15 +106,18 @@ public:
                 throw std::runtime_error("Unexpected entity.");
             }
         }
-        for(auto& b : bombs) {
+        for(int i = 0; i < bombCount; i++) {
+            const Bomb& b = bombs[i];
             board.placeBombOnly(b.owner, b.tile, b.explodeTurn - turn, b.blastLength);
         }
         board.aliveCount = playerCount;
         if(turn == 0) {
-            board.playerCount = playerCount;
-            board.US = ourID;
-            board.totalBoxes = boxCount;
+            gamePlayers = playerCount;
+            gameBoxes = boxCount;
         }
+        board.playerCount = gamePlayers;
+        board.US = ourID;
+        board.totalBoxes = gameBoxes;
         turn++;
     }
 };
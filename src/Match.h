@@ -0,0 +1,198 @@
+#ifndef HYPERSONIC_MATCH_H
+#define HYPERSONIC_MATCH_H
+
+#include <cstring>
+#include <cstdlib>
+
+#include "Board.h"
+#include "Params.h"
+#include "Simulation.h"
+#include "AnnealingBot.h"
+#include "Bot.h"
+#include "Heatmap.h"
+#include "TurnContext.h"
+
+using namespace std;
+
+/* One side of a self-play match. */
+class MatchPlayer {
+public:
+    virtual ~MatchPlayer() {}
+    virtual Move move(const Board& b) = 0;
+};
+
+template<int DEPTH>
+class BotPlayer : public MatchPlayer {
+    Bot<DEPTH> bot;
+    Heatmap heat;
+    bool heatBuilt = false;
+    TurnContext context;
+    Territory territory;
+    MoveOrdering ordering;
+
+public:
+    BotPlayer(int player, const ParamSet& params) : bot(player, params.bot) {
+        bot.quiet = true;
+        bot.setHeatmap(&heat);
+        bot.setContext(&context);
+        bot.setOrdering(&ordering);
+        bot.setTerritory(&territory);
+    }
+
+    Move move(const Board& b) {
+        context.build(b);
+        territory.build(b);
+        ordering.newTurn();
+        if(heatBuilt) {
+            heat.sync(b);
+        } else {
+            heat.build(b);
+            heatBuilt = true;
+        }
+        pair<int, bool> m = bot.move(b);
+        return Move(m.first, m.second);
+    }
+};
+
+class AnnealingPlayer : public MatchPlayer {
+    AnnealingBot<6, 2> bot;
+    MinimalBot enemy;
+    SimBot* enemies[1];
+
+public:
+    AnnealingPlayer(int player, int opponent, const ParamSet& params, long allocatedTimeMilli) :
+            bot(player, allocatedTimeMilli), enemy(opponent) {
+        bot.sFactors = params.score;
+        bot.schedule = params.schedule;
+        bot.quiet = true;
+        enemies[0] = &enemy;
+        bot.setEnemyAI(enemies);
+    }
+
+    Move move(const Board& b) {
+        return bot.move(b);
+    }
+};
+
+struct MatchResult {
+    static const int DRAW = -1;
+    int winner = DRAW;
+    int turns = 0;
+    int boxes[Board::MAX_PLAYERS] = {0};
+};
+
+/* Plays two bots against each other on a random map.
+ * The board is advanced the same way the bots simulate it (step forward, then apply every move), so the board each
+ * bot is given is exactly the one it would have predicted. The game ends when at most one player is left, when no
+ * boxes have been left for ENDGAME_TURNS, or at MAX_TURNS. The last player alive wins, otherwise the most boxes.
+ **/
+class Match {
+    static int32_t next(random_data& rng) {
+        int32_t r;
+        random_r(&rng, &r);
+        return r;
+    }
+
+public:
+    static const int MAX_TURNS = 200;
+    static const int ENDGAME_TURNS = 20;
+    static constexpr double BOX_DENSITY = 0.45;
+    static constexpr double ITEM_BOX_FRACTION = 0.3;
+
+    // A random map, symmetric under both reflections like the real ones. Walls on the odd grid points, and the
+    // corners kept clear for the players.
+    static Board randomBoard(unsigned int seed) {
+        // rand()'s sequence for the seed, from a state of its own so games on other threads can't draw from it.
+        random_data rng;
+        char state[128];
+        memset(&rng, 0, sizeof(rng));
+        initstate_r(seed, state, sizeof(state), &rng);
+        Board b;
+        memset(b.tiles, Board::INVALID, sizeof(b.tiles));
+        b.clearTimeline();
+        b.unsafe.reset();
+        b.turn = 0;
+        b.clearBombs();
+        int boxCount = 0;
+        for(int y = 0; y <= Board::HEIGHT / 2; y++) {
+            for(int x = 0; x <= Board::WIDTH / 2; x++) {
+                char tile = Board::EMPTY;
+                bool corner = x + y <= 1;
+                if(x % 2 == 1 && y % 2 == 1) {
+                    tile = Board::WALL;
+                } else if(!corner && (double) next(rng) / RAND_MAX < BOX_DENSITY) {
+                    tile = Board::BOX;
+                    if((double) next(rng) / RAND_MAX < ITEM_BOX_FRACTION) {
+                        tile = next(rng) % 2 == 0 ? Board::BOMB_RANGE_BOX : Board::BOMB_COUNT_BOX;
+                    }
+                }
+                int xs[] = {x, Board::WIDTH - 1 - x};
+                int ys[] = {y, Board::HEIGHT - 1 - y};
+                for(int i = 0; i < 2; i++) {
+                    for(int j = 0; j < 2; j++) {
+                        int t = Board::toID(ys[j], xs[i]);
+                        if(b.tiles[t] != tile) {
+                            b.tiles[t] = tile;
+                            if(b.isBox(t)) boxCount++;
+                        }
+                    }
+                }
+            }
+        }
+        b.players[0] = Player(Board::toID(0, 0));
+        b.players[1] = Player(Board::toID(Board::HEIGHT - 1, Board::WIDTH - 1));
+        for(int p = 2; p < Board::MAX_PLAYERS; p++) {
+            b.players[p] = Player();
+        }
+        b.aliveCount = 2;
+        b.playerCount = 2;
+        b.US = 0;
+        b.totalBoxes = boxCount;
+        return b;
+    }
+
+    static MatchResult play(MatchPlayer* first, MatchPlayer* second, unsigned int seed, int maxTurns = MAX_TURNS) {
+        MatchPlayer* players[] = {first, second};
+        Board b = randomBoard(seed);
+        MatchResult result;
+        int turnsWithoutBoxes = 0;
+        for(; result.turns < maxTurns && b.aliveCount > 1 && turnsWithoutBoxes < ENDGAME_TURNS; result.turns++) {
+            Move moves[2];
+            for(int p = 0; p < 2; p++) {
+                if(!b.players[p].isAlive()) continue;
+                b.US = p;
+                moves[p] = players[p]->move(b);
+            }
+            b.stepForward(1);
+            for(int p = 0; p < 2; p++) {
+                if(!b.players[p].isAlive()) continue;
+                if(moves[p].bomb && b.players[p].bombsAvailable > 0 && b.tiles[b.players[p].tile] != Board::BOMB) {
+                    b.placeBomb(p);
+                }
+                if(b.canMove(p, moves[p].dir)) {
+                    b.move(p, moves[p].dir);
+                }
+            }
+            bool boxesLeft = false;
+            for(int i = 0; i < Board::TILE_COUNT && !boxesLeft; i++) {
+                boxesLeft = b.isBox(i);
+            }
+            turnsWithoutBoxes = boxesLeft ? 0 : turnsWithoutBoxes + 1;
+        }
+        bool alive0 = b.players[0].isAlive();
+        bool alive1 = b.players[1].isAlive();
+        // Let the bombs already placed finish, so the box counts are final.
+        b.stepForward(Bomb::TIMEOUT);
+        for(int p = 0; p < 2; p++) {
+            result.boxes[p] = b.players[p].boxesDestroyed;
+        }
+        if(alive0 != alive1) {
+            result.winner = alive0 ? 0 : 1;
+        } else if(result.boxes[0] != result.boxes[1]) {
+            result.winner = result.boxes[0] > result.boxes[1] ? 0 : 1;
+        }
+        return result;
+    }
+};
+
+#endif //HYPERSONIC_MATCH_H
@@ -1,9 +1,10 @@
 #ifndef HYPERSONIC_MECHANICS_H
 #define HYPERSONIC_MECHANICS_H
 
-#include <unordered_set>
+#include <bitset>
 #include "Position.h"
 #include "Board.h"
+#include "TurnContext.h"
 
 using namespace std;
 
@@ -44,20 +45,16 @@ public:
         int totalScored = 0; // Ignoring double score.
         for(int t = 0; t < Bomb::TIMEOUT; t++) {
             for (int i = 0; i < b.playerCount; i++) {
-                totalScored += b.scoresM[t][i];
+                totalScored += b.scores(t)[i];
             }
         }
         return b.totalBoxes - totalScored;
     }
 
-
-    static int seen[Board::TILE_COUNT];
-    static TilePlayer qu[Board::TILE_COUNT];
-    static int quInt[Board::TILE_COUNT];
-    static int neigh[4];
-
     static pair<int, int> closestPlayer(const Board& b, int fromPlayer) {
-        memset(seen, 0, sizeof(seen));
+        bool seen[Board::TILE_COUNT] = {false};
+        int quInt[Board::TILE_COUNT];
+        int neigh[4];
         int qIn = 0;
         int qOut = 0;
         int neighCount = 0;
@@ -88,8 +85,11 @@ public:
         return {-1, -1};
     };
 
-    static int stepsToClosestBox(const Board& b, int player) {
-        memset(seen, 0, sizeof(seen));
+    // With a context of the turn, boxes doomed at the root are skipped without checking the timeline.
+    static int stepsToClosestBox(const Board& b, int player, const TurnContext* context = NULL) {
+        bool seen[Board::TILE_COUNT] = {false};
+        int quInt[Board::TILE_COUNT];
+        int neigh[4];
         int qIn = 0;
         int qOut = 0;
         int count = 0;
@@ -105,9 +105,9 @@ public:
                     if(n == Board::INVALID_TILE || seen[n]) continue;
                     seen[n] = true;
                     if(b.isBox(n)){
-                        bool exp = false;
-                        for(int f = 0; f < Bomb::TIMEOUT; f++) {
-                            if(b.explodeM[f][n]) {
+                        bool exp = context != NULL && context->isDoomed(n);
+                        for(int f = 0; f < Bomb::TIMEOUT && !exp; f++) {
+                            if(b.explodes(f)[n]) {
                                 exp = true;
                                 break;
                             }
@@ -125,7 +125,9 @@ public:
         return -1;
     }
     static int closestCount(const Board& b, int player) {
-        memset(seen, 0, sizeof(seen));
+        bool seen[Board::TILE_COUNT] = {false};
+        TilePlayer qu[Board::TILE_COUNT];
+        int neigh[4];
         int qIn = 0;
         int qOut = 0;
         int count = 0;
@@ -182,7 +184,7 @@ public:
     static int score(const Board& b, int player) {
         int score = b.players[player].boxesDestroyed;
         for(int i = 0; i < Bomb::TIMEOUT; i++) {
-            score += b.scoresM[i][player];
+            score += b.scores(i)[player];
         }
     }
 
@@ -193,17 +195,29 @@ public:
 
 };
 
+/* A tile to bomb from, with the boxes its blast would destroy. */
+struct BombSpot {
+    int tile;
+    int steps;
+    int boxes;
+};
+
+/* Tactical queries. All work from fixed size arrays on the stack, and leave the board they are given unchanged,
+ * so they can be called from leaf evaluation.
+ **/
 class Mechanics {
 public:
 
-    pair<int, int> closestPosToBomb(Board board, int from, const unordered_set<int> &boxes) {
+    // The box side closest to from (by Manhattan distance), as (box, side). The last of equal sides wins.
+    static pair<int, int> closestPosToBomb(int from, const int boxes[], int boxCount) {
         pair<int, int> ans = pair<int, int>(Position::INVALID_IDX, Position::INVALID_IDX);
         int min = std::numeric_limits<int>::max();
-        for (auto &box : boxes) {
-            vector<int> neigh = board.neighbours(box);
-            for (auto &neighbour : neigh) {
-                if (board.dist(from, neighbour) <= min) {
-                    min = board.dist(from, neighbour);
+        for (int b = 0; b < boxCount; b++) {
+            int box = boxes[b];
+            for (int i = 0; i < Board::grid.neighbourCount[box]; i++) {
+                int neighbour = Board::grid.neighbours[box][i];
+                if (Board::dist(from, neighbour) <= min) {
+                    min = Board::dist(from, neighbour);
                     ans = pair<int, int>(box, neighbour);
                 }
             }
@@ -211,34 +225,25 @@ public:
         return ans;
     }
 
-// Returns -1 if none found.
-    int maximizeBlast(Board board, int player, int steps, int blastLength) {
-        int max = 0;
-        int pos = -1;
-        for (auto t : board.reachableFrom(board.playerTile(player), steps)) {
-            board.stepForward(board.pathDist(board.playerTile(player), t)); // +1 ?
-            int score = blastCount(board, Board::toPosition(t), blastLength);
-            cerr << "score : " << score << "  at: " << t << endl;
-            if (score > max) {
-                max = score;
-                pos = t;
-            }
-        }
-        return pos;
+    // The board once every bomb on it has gone off. Boxes which are already doomed no longer count, so blast
+    // counts can be taken from this one snapshot for any tile.
+    static Board settled(const Board& board) {
+        Board snapshot = board;
+        snapshot.stepForward(Bomb::TIMEOUT);
+        return snapshot;
     }
 
-
-// Only works for single bombs, currently.
-    int blastCount(Board board, Position bombPos, int blastLength) {
-        board.stepForward(Bomb::TIMEOUT);
+    // Boxes a bomb at tile would destroy on a settled board.
+    static int blastCountAt(const Board& snapshot, int tile, int blastLength) {
+        const Position& p = Board::toPosition(tile);
         int boxCount = 0;
         for (int dir = Position::RIGHT; dir <= Position::UP; dir++) {
             for (int i = 1; i <= blastLength; i++) {
-                int t = board.tileAt(bombPos, dir, i);
-                if (board.tiles[t] == Board::INVALID_TILE || board.tiles[t] == Board::WALL) {
+                int t = Board::tileAt(p, dir, i);
+                if (t == Board::INVALID_TILE || snapshot.tiles[t] == Board::WALL) {
                     break;
                 }
-                if (board.isBox(t)) {
+                if (snapshot.isBox(t)) {
                     boxCount++;
                     break;
                 }
@@ -247,53 +252,103 @@ public:
         return boxCount;
     }
 
-    int closestBoxSide(Board board, int fromTile) {
-        unordered_set<int> seen;
-        queue<int> q;
-        queue<int> fromQueue;
-        q.push(fromTile);
-        fromQueue.push(fromTile);
-        while (!q.empty()) {
-            int size = q.size();
-            for (int i = 0; i < size; i++) {
-                int t = q.front();
-                int tPrev = fromQueue.front();
-                q.pop();
-                fromQueue.pop();
-                if (seen.count(t)) continue;
-                seen.insert(t);
-                if (board.isBox(t)) {
-                    return tPrev;
-                }
-                for (auto n : board.neighbours(t)) {
-                    q.push(n);
-                    fromQueue.push(t);
-                }
+    // Only works for single bombs, currently.
+    static int blastCount(const Board& board, Position bombPos, int blastLength) {
+        return blastCountAt(settled(board), Board::toID(bombPos), blastLength);
+    }
+
+    // Every tile reachable in fewer than steps moves, in breadth first order, with the boxes a bomb there would
+    // destroy. The blasts are all taken from one settled snapshot. Returns the number of spots written to out.
+    static int bombSpots(const Board& board, int from, int steps, int blastLength, BombSpot out[]) {
+        Board snapshot = settled(board);
+        bitset<Board::TILE_COUNT> seen;
+        int queue[Board::TILE_COUNT];
+        int dist[Board::TILE_COUNT];
+        int qIn = 0;
+        int qOut = 0;
+        int count = 0;
+        queue[qIn++] = from;
+        dist[from] = 0;
+        seen.set(from);
+        while (qOut < qIn) {
+            int t = queue[qOut++];
+            if (dist[t] >= steps) break;
+            out[count++] = {t, dist[t], blastCountAt(snapshot, t, blastLength)};
+            for (int i = 0; i < Board::grid.neighbourCount[t]; i++) {
+                int n = Board::grid.neighbours[t][i];
+                if (seen[n] || !board.isFree(n)) continue;
+                seen.set(n);
+                dist[n] = dist[t] + 1;
+                queue[qIn++] = n;
+            }
+        }
+        return count;
+    }
+
+    // The best spot to bomb within fewer than steps moves. Returns -1 if none found.
+    static int maximizeBlast(const Board& board, int player, int steps, int blastLength) {
+        BombSpot spots[Board::TILE_COUNT];
+        int count = bombSpots(board, board.playerTile(player), steps, blastLength, spots);
+        int max = 0;
+        int pos = -1;
+        for (int i = 0; i < count; i++) {
+            if (spots[i].boxes > max) {
+                max = spots[i].boxes;
+                pos = spots[i].tile;
+            }
+        }
+        return pos;
+    }
+
+    // The tile from which the nearest box was first reached. Walls are searched through, as before.
+    static int closestBoxSide(const Board& board, int fromTile) {
+        bitset<Board::TILE_COUNT> seen;
+        int queue[Board::TILE_COUNT];
+        int from[Board::TILE_COUNT];
+        int qIn = 0;
+        int qOut = 0;
+        queue[qIn++] = fromTile;
+        from[fromTile] = fromTile;
+        seen.set(fromTile);
+        while (qOut < qIn) {
+            int t = queue[qOut++];
+            if (board.isBox(t)) {
+                return from[t];
+            }
+            for (int i = 0; i < Board::grid.neighbourCount[t]; i++) {
+                int n = Board::grid.neighbours[t][i];
+                if (seen[n]) continue;
+                seen.set(n);
+                from[n] = t;
+                queue[qIn++] = n;
             }
         }
         return -1;
     }
 
-    int stepsToNearestBox(const Board &b, int player) {
-        queue<int> queue;
-        unordered_set<int> seen;
-        queue.push(b.players[player].tile);
-        seen.insert(b.players[player].tile);
-        int size;
-        int steps = 0;
-        while (!queue.empty()) {
-            size = queue.size();
-            for (int i = 0; i < size; i++) {
-                int t = queue.front();
-                queue.pop();
-                if (b.isBox(b.tiles[t])) {
-                    return steps;
-                }
-                for (auto n : b.freeNeighbours(t)) {
-                    queue.push(n);
+    // Steps to reach a tile next to a box, over free tiles.
+    static int stepsToNearestBox(const Board &b, int player) {
+        bitset<Board::TILE_COUNT> seen;
+        int queue[Board::TILE_COUNT];
+        int steps[Board::TILE_COUNT];
+        int qIn = 0;
+        int qOut = 0;
+        int start = b.players[player].tile;
+        queue[qIn++] = start;
+        steps[start] = 0;
+        seen.set(start);
+        while (qOut < qIn) {
+            int t = queue[qOut++];
+            for (int i = 0; i < Board::grid.neighbourCount[t]; i++) {
+                int n = Board::grid.neighbours[t][i];
+                if (b.isBox(n)) {
+                    return steps[t];
                 }
+                if (seen[n] || !b.isFree(n)) continue;
+                seen.set(n);
+                steps[n] = steps[t] + 1;
+                queue[qIn++] = n;
             }
-            steps++;
         }
         return -1;
     }
@@ -0,0 +1,193 @@
+#ifndef HYPERSONIC_MEMORYARENA_H
+#define HYPERSONIC_MEMORYARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+
+/* Bump allocator over one block, allocated up front.
+ * Allocating moves a pointer; reset() frees everything at once, so a search can take boards and node records for
+ * a turn and drop them all at the start of the next. Nothing is destructed: only trivially destructible types
+ * (Board, Move, plain node structs) belong here. An arena isn't thread safe; each worker thread uses its own, see
+ * forThread().
+ **/
+class MemoryArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 8 << 20;
+
+private:
+    char* base;
+    size_t capacity;
+    size_t used = 0;
+    size_t peak = 0;
+
+    MemoryArena(const MemoryArena&);
+    MemoryArena& operator=(const MemoryArena&);
+
+public:
+    explicit MemoryArena(size_t capacity = DEFAULT_CAPACITY) : base(new char[capacity]), capacity(capacity) {}
+
+    ~MemoryArena() {
+        delete[] base;
+    }
+
+    // NULL when the arena is full; the caller decides whether to search less or fail.
+    void* allocate(size_t size, size_t align = alignof(max_align_t)) {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if(start + size > capacity) return NULL;
+        used = start + size;
+        if(used > peak) peak = used;
+        return base + start;
+    }
+
+    // count default constructed Ts, or NULL when full.
+    template<typename T>
+    T* make(int count = 1) {
+        void* p = allocate(sizeof(T) * count, alignof(T));
+        if(p == NULL) return NULL;
+        T* items = static_cast<T*>(p);
+        for(int i = 0; i < count; i++) {
+            new(items + i) T();
+        }
+        return items;
+    }
+
+    void reset() {
+        used = 0;
+    }
+
+    // A point to rewind to, so a caller can free what it took without dropping what came before it.
+    size_t mark() const {
+        return used;
+    }
+
+    void rewind(size_t m) {
+        used = m;
+    }
+
+    size_t bytesUsed() const {
+        return used;
+    }
+
+    size_t bytesFree() const {
+        return capacity - used;
+    }
+
+    // The most in use at once, to size the capacity from real games.
+    size_t peakBytes() const {
+        return peak;
+    }
+
+    // The calling thread's arena. Created on the thread's first call, with the default capacity.
+    static MemoryArena& forThread() {
+        static thread_local MemoryArena arena;
+        return arena;
+    }
+};
+
+/* Gives an arena back what was taken from it while the scope was open, however the scope is left. An engine's
+ * move() opens one on its thread's arena, so it can be called any number of times a turn.
+ **/
+class ArenaScope {
+    MemoryArena& arena;
+    size_t start;
+
+    ArenaScope(const ArenaScope&);
+    ArenaScope& operator=(const ArenaScope&);
+
+public:
+    explicit ArenaScope(MemoryArena& arena) : arena(arena), start(arena.mark()) {}
+
+    ~ArenaScope() {
+        arena.rewind(start);
+    }
+};
+
+/* A fixed number of Ts, carved out of an arena (or the heap) and handed out in order.
+ * Pools are the typed part: BeamBot's layer boards, and the node boards of ParanoidBot and EndgameBot, are pools
+ * taken from the thread's arena at the start of each move. A pool reset is O(1), and unlike the arena's, leaves the
+ * rest of the arena alone.
+ **/
+template<typename T>
+class ArenaPool {
+    T* items = NULL;
+    int cap = 0;
+    int count = 0;
+    bool owned = false;
+
+    ArenaPool(const ArenaPool&);
+    ArenaPool& operator=(const ArenaPool&);
+
+public:
+    ArenaPool() {}
+
+    ArenaPool(MemoryArena& arena, int capacity) {
+        init(arena, capacity);
+    }
+
+    explicit ArenaPool(int capacity) : items(new T[capacity]), cap(capacity), owned(true) {}
+
+    ~ArenaPool() {
+        if(owned) delete[] items;
+    }
+
+    // False if the arena hasn't room for the pool, which is then empty.
+    bool init(MemoryArena& arena, int capacity) {
+        if(owned) delete[] items;
+        owned = false;
+        count = 0;
+        items = arena.make<T>(capacity);
+        cap = items == NULL ? 0 : capacity;
+        return items != NULL;
+    }
+
+    // From the heap, for when the arena is full.
+    void init(int capacity) {
+        if(owned) delete[] items;
+        items = new T[capacity];
+        cap = capacity;
+        count = 0;
+        owned = true;
+    }
+
+    // NULL when the pool is used up.
+    T* take() {
+        return count < cap ? &items[count++] : NULL;
+    }
+
+    // n consecutive Ts (a move list, say), or NULL.
+    T* take(int n) {
+        if(count + n > cap) return NULL;
+        T* first = &items[count];
+        count += n;
+        return first;
+    }
+
+    T& operator[](int i) {
+        return items[i];
+    }
+
+    const T& operator[](int i) const {
+        return items[i];
+    }
+
+    void reset() {
+        count = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    int capacity() const {
+        return cap;
+    }
+
+    bool full() const {
+        return count == cap;
+    }
+};
+
+#endif //HYPERSONIC_MEMORYARENA_H
@@ -0,0 +1,148 @@
+#ifndef HYPERSONIC_MOVEORDERING_H
+#define HYPERSONIC_MOVEORDERING_H
+
+#include <cstring>
+
+#include "Board.h"
+#include "Simulation.h"
+
+using namespace std;
+
+/* Move ordering for the depth first searches.
+ * Moves are tried in this order: the move of the previous principal variation (while the search is still
+ * following it), the killer moves of the ply (good moves at the same ply elsewhere in the tree), then by history:
+ * how often, and how deep, a move from the same tile has been good. The tables outlive a search. newTurn() shifts
+ * the principal variation and the killers by the turn which has passed, and halves the history, so the ordering
+ * follows the game.
+ **/
+class MoveOrdering {
+public:
+    static const int MAX_PLY = 32;
+    static const int KILLERS = 2;
+    static const int MOVE_KINDS = Position::DIR_COUNT * 2;
+    static const int PV_PRIORITY = 1 << 30;
+    static const int KILLER_PRIORITY = 1 << 29;
+
+private:
+    int history[Board::TILE_COUNT][MOVE_KINDS];
+    Move killers[MAX_PLY][KILLERS];
+    int killerCount[MAX_PLY];
+    Move pv[MAX_PLY];
+    int pvLength = 0;
+
+    static int kind(const Move& m) {
+        return m.dir * 2 + (m.bomb ? 1 : 0);
+    }
+
+    static bool same(const Move& a, const Move& b) {
+        return a.dir == b.dir && a.bomb == b.bomb;
+    }
+
+public:
+    MoveOrdering() {
+        clear();
+    }
+
+    void clear() {
+        memset(history, 0, sizeof(history));
+        memset(killers, 0, sizeof(killers));
+        memset(killerCount, 0, sizeof(killerCount));
+        pvLength = 0;
+    }
+
+    // Higher is tried first. onPV: the moves so far are the principal variation's.
+    int priority(int ply, int tile, const Move& m, bool onPV) const {
+        if(ply >= MAX_PLY) return history[tile][kind(m)];
+        if(onPV && ply < pvLength && same(pv[ply], m)) return PV_PRIORITY;
+        for(int k = 0; k < killerCount[ply]; k++) {
+            if(same(killers[ply][k], m)) return KILLER_PRIORITY - k;
+        }
+        return history[tile][kind(m)];
+    }
+
+    // Whether m is the principal variation's move at ply.
+    bool onPV(int ply, const Move& m) const {
+        return ply < pvLength && same(pv[ply], m);
+    }
+
+    // Best first. Stable, so moves of equal priority keep their order.
+    void order(int ply, int tile, bool onPV, Move moves[], int count) const {
+        int priorities[MOVE_KINDS];
+        for(int i = 0; i < count; i++) {
+            priorities[i] = priority(ply, tile, moves[i], onPV);
+        }
+        for(int i = 1; i < count; i++) {
+            Move m = moves[i];
+            int p = priorities[i];
+            int j = i;
+            for(; j > 0 && priorities[j - 1] < p; j--) {
+                moves[j] = moves[j - 1];
+                priorities[j] = priorities[j - 1];
+            }
+            moves[j] = m;
+            priorities[j] = p;
+        }
+    }
+
+    // m, from tile at ply, caused a cutoff or a new best, with remaining plies below it.
+    void good(int ply, int tile, const Move& m, int remaining) {
+        int& h = history[tile][kind(m)];
+        h += remaining * remaining;
+        // Keep clear of the killer and PV priorities.
+        if(h >= KILLER_PRIORITY / 2) {
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                for(int k = 0; k < MOVE_KINDS; k++) {
+                    history[t][k] >>= 1;
+                }
+            }
+        }
+        if(ply >= MAX_PLY) return;
+        if(killerCount[ply] > 0 && same(killers[ply][0], m)) return;
+        // Only the killers already set move down, the last one dropping off when the ply is full.
+        int last = killerCount[ply] < KILLERS ? killerCount[ply] : KILLERS - 1;
+        for(int k = last; k > 0; k--) {
+            killers[ply][k] = killers[ply][k - 1];
+        }
+        killers[ply][0] = m;
+        if(killerCount[ply] < KILLERS) killerCount[ply]++;
+    }
+
+    void setPV(const Move line[], int length) {
+        pvLength = length < MAX_PLY ? length : MAX_PLY;
+        for(int i = 0; i < pvLength; i++) {
+            pv[i] = line[i];
+        }
+    }
+
+    int pvSize() const {
+        return pvLength;
+    }
+
+    const Move& pvMove(int ply) const {
+        return pv[ply];
+    }
+
+    // A turn has been played: ply p of the next search is ply p + 1 of the last one.
+    void newTurn() {
+        if(pvLength > 0) {
+            for(int i = 1; i < pvLength; i++) {
+                pv[i - 1] = pv[i];
+            }
+            pvLength--;
+        }
+        for(int p = 1; p < MAX_PLY; p++) {
+            killerCount[p - 1] = killerCount[p];
+            for(int k = 0; k < killerCount[p]; k++) {
+                killers[p - 1][k] = killers[p][k];
+            }
+        }
+        killerCount[MAX_PLY - 1] = 0;
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            for(int k = 0; k < MOVE_KINDS; k++) {
+                history[t][k] >>= 1;
+            }
+        }
+    }
+};
+
+#endif //HYPERSONIC_MOVEORDERING_H
@@ -0,0 +1,78 @@
+#ifndef HYPERSONIC_OPENING_H
+#define HYPERSONIC_OPENING_H
+
+#include "Board.h"
+#include "Heatmap.h"
+#include "TurnContext.h"
+#include "MoveOrdering.h"
+#include "BeamBot.h"
+
+using namespace std;
+
+/* The first turn's larger budget, spent before the game gets going.
+ * prepare() builds the heatmap (and its blast rays) for the turns after it to sync, and runs a wide, deep beam
+ * search for a box farming plan. While our moves keep to the plan, seed() hands the rest of it to the move ordering
+ * as the principal variation, so the depth first searches try it first. The first move off the plan, or a board
+ * where we aren't where the plan put us, drops it for good.
+ **/
+class Opening {
+public:
+    static const int PLIES = 15;
+    static const int WIDTH = 400;
+    // Of the referee's 1000ms first turn, leaving the rest for the turn's own search.
+    static const long DEFAULT_TIME = 500;
+
+    Move plan[BeamBot::MAX_PLIES];
+    int planLength = 0;
+    int playedCount = 0;
+
+private:
+    int player;
+    long allocatedTime;
+    int expectedTile = Board::INVALID_TILE;
+
+public:
+    Opening(int player, long allocatedTimeMilli = DEFAULT_TIME) : player(player), allocatedTime(allocatedTimeMilli) {}
+
+    // b is the first turn's board as observed, and context already built from it.
+    void prepare(const Board& b, Heatmap& heat, const TurnContext& context) {
+        heat.build(b);
+        BeamBot beam(player, allocatedTime, WIDTH);
+        beam.setContext(&context);
+        beam.maxPlies = PLIES;
+        beam.move(b);
+        planLength = beam.planLength;
+        for(int i = 0; i < planLength; i++) {
+            plan[i] = beam.plan[i];
+        }
+        playedCount = 0;
+        expectedTile = b.players[player].tile;
+        cerr << "Opening plan: " << planLength << " plies" << endl;
+    }
+
+    // Whether the plan still holds on this turn's board.
+    bool onPlan(const Board& b) const {
+        return playedCount < planLength && b.players[player].tile == expectedTile;
+    }
+
+    void seed(MoveOrdering& ordering) const {
+        ordering.setPV(plan + playedCount, planLength - playedCount);
+    }
+
+    // The move we played on b. Anything but the plan's next move ends it.
+    void played(const Board& b, pair<int, bool> move) {
+        if(!onPlan(b) || plan[playedCount].dir != move.first || plan[playedCount].bomb != move.second) {
+            planLength = 0;
+            return;
+        }
+        // Moves are made after the step, as the searches make them.
+        Board next = b;
+        next.stepForward(1);
+        if(next.canMove(player, move.first)) {
+            expectedTile = Board::adjTile(next.players[player].tile, move.first);
+        }
+        playedCount++;
+    }
+};
+
+#endif //HYPERSONIC_OPENING_H
@@ -0,0 +1,177 @@
+#ifndef HYPERSONIC_OPPONENTMODEL_H
+#define HYPERSONIC_OPPONENTMODEL_H
+
+#include <cstring>
+
+#include "Board.h"
+#include "Simulation.h"
+
+using namespace std;
+
+/* Learns how each enemy plays from the moves we see them make.
+ * Every turn the new board is compared with the previous one to recover each enemy's action: whether it moved,
+ * and whether it left a new bomb behind. The action is tallied in a frequency table conditioned on a small local
+ * context of the board the enemy decided on: is it next to a box, is its tile about to explode, and does it have a
+ * bomb. Predictions take the most frequent action class for the context, backed off to the counts pooled over all
+ * enemies while a player has few observations. The direction of a move is not learned; it is the first step
+ * towards the nearest box side, or any safe tile when in danger.
+ **/
+class OpponentModel {
+public:
+    enum Action {STAY, MOVE, BOMB_STAY, BOMB_MOVE};
+    static const int ACTION_COUNT = 4;
+    static const int CONTEXT_COUNT = 8;
+    static const int DANGER_TURNS = 3;
+
+private:
+    static constexpr double POOLED_WEIGHT = 0.5;
+
+    int counts[Board::MAX_PLAYERS][CONTEXT_COUNT][ACTION_COUNT];
+    int pooled[CONTEXT_COUNT][ACTION_COUNT];
+    int observed[Board::MAX_PLAYERS];
+    Board prev;
+    bool hasPrev = false;
+
+    static bool isBomb(const Board& b, int tile, int owner) {
+        for(int i = 0; i < b.bombCount; i++) {
+            if(b.bombs[i].tile == tile && b.bombs[i].owner == owner) return true;
+        }
+        return false;
+    }
+
+    // First step of a shortest path to a tile next to a box, or Position::NONE if there is none. Steps into tiles
+    // which are exploding next turn are not taken.
+    static int stepTowardsBox(const Board& b, int player) {
+        int start = b.players[player].tile;
+        int firstStep[Board::TILE_COUNT];
+        int queue[Board::TILE_COUNT];
+        bool seen[Board::TILE_COUNT] = {false};
+        int neigh[4];
+        int neighCount;
+        int qIn = 0;
+        int qOut = 0;
+        seen[start] = true;
+        for(int d = Position::RIGHT; d <= Position::UP; d++) {
+            if(!b.canMove(player, d)) continue;
+            int n = Board::adjTile(start, d);
+            if(!b.willBeFree(n, 1, d)) continue;
+            seen[n] = true;
+            firstStep[n] = d;
+            queue[qIn++] = n;
+        }
+        while(qOut < qIn) {
+            int t = queue[qOut++];
+            b.neighbours(t, neigh, &neighCount);
+            for(int i = 0; i < neighCount; i++) {
+                int n = neigh[i];
+                if(b.isBox(n) && b.earliestExp(n) == 0) return firstStep[t];
+                if(seen[n] || !b.isFree(n)) continue;
+                seen[n] = true;
+                firstStep[n] = firstStep[t];
+                queue[qIn++] = n;
+            }
+        }
+        return qIn > 0 ? firstStep[queue[0]] : (int) Position::NONE;
+    }
+
+public:
+    OpponentModel() {
+        reset();
+    }
+
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        memset(pooled, 0, sizeof(pooled));
+        memset(observed, 0, sizeof(observed));
+        hasPrev = false;
+    }
+
+    static int context(const Board& b, int player) {
+        int tile = b.players[player].tile;
+        int neigh[4];
+        int neighCount;
+        bool nextToBox = false;
+        b.neighbours(tile, neigh, &neighCount);
+        for(int i = 0; i < neighCount; i++) {
+            if(b.isBox(neigh[i])) nextToBox = true;
+        }
+        int exp = b.earliestExp(tile);
+        bool danger = exp != 0 && exp <= DANGER_TURNS;
+        bool hasBomb = b.players[player].bombsAvailable > 0;
+        return nextToBox | danger << 1 | hasBomb << 2;
+    }
+
+    // Call once per turn with the freshly parsed board.
+    void observe(const Board& b) {
+        if(hasPrev) {
+            for(int p = 0; p < b.playerCount; p++) {
+                if(p == b.US || !prev.players[p].isAlive() || !b.players[p].isAlive()) continue;
+                int from = prev.players[p].tile;
+                int to = b.players[p].tile;
+                if(Board::dist(from, to) > 1) continue;
+                bool moved = from != to;
+                bool bombed = isBomb(b, from, p) && !isBomb(prev, from, p);
+                int action = (bombed ? BOMB_STAY : STAY) + (moved ? 1 : 0);
+                int ctx = context(prev, p);
+                counts[p][ctx][action]++;
+                pooled[ctx][action]++;
+                observed[p]++;
+            }
+        }
+        prev = b;
+        hasPrev = true;
+    }
+
+    int observations(int player) const {
+        return observed[player];
+    }
+
+    int count(int player, int ctx, int action) const {
+        return counts[player][ctx][action];
+    }
+
+    int predictAction(const Board& b, int player) const {
+        int ctx = context(b, player);
+        int best = STAY;
+        double bestWeight = 0;
+        for(int a = 0; a < ACTION_COUNT; a++) {
+            double weight = counts[player][ctx][a] + POOLED_WEIGHT * pooled[ctx][a];
+            if(weight > bestWeight) {
+                best = a;
+                bestWeight = weight;
+            }
+        }
+        return best;
+    }
+
+    Move predict(const Board& b, int player) const {
+        int action = predictAction(b, player);
+        bool bomb = (action == BOMB_STAY || action == BOMB_MOVE) && b.players[player].bombsAvailable > 0
+                    && b.tiles[b.players[player].tile] != Board::BOMB;
+        int dir = Position::NONE;
+        if(action == MOVE || action == BOMB_MOVE) {
+            dir = stepTowardsBox(b, player);
+        }
+        return Move(dir, bomb);
+    }
+};
+
+/* SimBot backed by the learned model, for the annealing simulation and the exhaustive search. */
+class ModelBot : public SimBot {
+    const OpponentModel* model;
+    int player_;
+
+public:
+    ModelBot() {}
+    ModelBot(const OpponentModel* model, int player) : model(model), player_(player) {}
+
+    Move move(Board& b) {
+        return model->predict(b, player_);
+    }
+
+    int player() {
+        return player_;
+    }
+};
+
+#endif //HYPERSONIC_OPPONENTMODEL_H
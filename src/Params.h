@@ -0,0 +1,154 @@
+#ifndef HYPERSONIC_PARAMS_H
+#define HYPERSONIC_PARAMS_H
+
+#include <iostream>
+#include <string>
+#include <cstring>
+
+/* Weights of the exhaustive search leaf evaluation (Bot, and the bots which share its heuristic). */
+struct BotFactors {
+    double boxSF;
+    double boxDepreciation;
+    double powerupSF;
+    double bombsAvailableSF;
+    double closestSF;
+    double heatSF;
+    double territorySF;
+};
+
+/* Weights of the plan evaluation of the Simulation based bots. */
+struct ScoreFactors {
+    double boxesDestroyed;
+    double boxDepreciation;
+    double rangePU;
+    double countPU;
+    double enemyDeath;
+    double victory;
+    double defeat;
+};
+
+/* Cooling schedule of the AnnealingBot, used until its timing estimates take over. */
+struct AnnealingSchedule {
+    double initTemp;
+    double initCoolingFraction;
+    double startAcceptanceRate;
+    double endAcceptanceRate;
+    double stepsVsCoolRatio;
+    double initCoolingSteps;
+    double initStepsPerTemp;
+};
+
+/* Every runtime parameter. The bots copy the part they need, so the hot paths read plain members. */
+struct ParamSet {
+    BotFactors bot;
+    ScoreFactors score;
+    AnnealingSchedule schedule;
+};
+
+/* A named view of one parameter, with the range the tuner may search. */
+struct Param {
+    const char* name;
+    double* value;
+    double min;
+    double max;
+};
+
+class Params {
+public:
+    static const int MAX_PARAMS = 32;
+
+    // Fills out with every parameter of p. Returns the count.
+    static int list(ParamSet& p, Param out[]) {
+        int n = 0;
+        out[n++] = {"bot.boxSF", &p.bot.boxSF, 0.1, 4};
+        out[n++] = {"bot.boxDepreciation", &p.bot.boxDepreciation, 0.5, 1};
+        out[n++] = {"bot.powerupSF", &p.bot.powerupSF, 0, 1};
+        out[n++] = {"bot.bombsAvailableSF", &p.bot.bombsAvailableSF, 0, 1};
+        out[n++] = {"bot.closestSF", &p.bot.closestSF, 0, 0.1};
+        out[n++] = {"bot.heatSF", &p.bot.heatSF, 0, 0.1};
+        out[n++] = {"bot.territorySF", &p.bot.territorySF, 0, 0.5};
+        out[n++] = {"score.boxesDestroyed", &p.score.boxesDestroyed, 0.1, 4};
+        out[n++] = {"score.boxDepreciation", &p.score.boxDepreciation, 0.5, 1};
+        out[n++] = {"score.rangePU", &p.score.rangePU, 0, 1};
+        out[n++] = {"score.countPU", &p.score.countPU, 0, 1};
+        out[n++] = {"score.enemyDeath", &p.score.enemyDeath, 0, 200};
+        out[n++] = {"score.victory", &p.score.victory, 0, 1000};
+        out[n++] = {"score.defeat", &p.score.defeat, -1000, 0};
+        out[n++] = {"schedule.initTemp", &p.schedule.initTemp, 100, 50000};
+        out[n++] = {"schedule.initCoolingFraction", &p.schedule.initCoolingFraction, 0.5, 0.999};
+        out[n++] = {"schedule.startAcceptanceRate", &p.schedule.startAcceptanceRate, 0.5, 0.999};
+        out[n++] = {"schedule.endAcceptanceRate", &p.schedule.endAcceptanceRate, 1e-12, 0.1};
+        out[n++] = {"schedule.stepsVsCoolRatio", &p.schedule.stepsVsCoolRatio, 0.2, 5};
+        out[n++] = {"schedule.initCoolingSteps", &p.schedule.initCoolingSteps, 10, 1000};
+        out[n++] = {"schedule.initStepsPerTemp", &p.schedule.initStepsPerTemp, 10, 1000};
+        return n;
+    }
+
+    // One "name value" pair per line. Unknown names are an error, missing names keep their value.
+    static bool load(std::istream& in, ParamSet& p) {
+        Param all[MAX_PARAMS];
+        int count = list(p, all);
+        std::string name;
+        double value;
+        while(in >> name >> value) {
+            bool found = false;
+            for(int i = 0; i < count; i++) {
+                if(name == all[i].name) {
+                    *all[i].value = value;
+                    found = true;
+                }
+            }
+            if(!found) {
+                std::cerr << "Unknown parameter: " << name << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void save(std::ostream& out, ParamSet& p) {
+        Param all[MAX_PARAMS];
+        int count = list(p, all);
+        out.precision(17);
+        for(int i = 0; i < count; i++) {
+            out << all[i].name << " " << *all[i].value << "\n";
+        }
+    }
+
+    // Writes TunedParams.h, which holds the defaults compiled into the bot.
+    static void writeHeader(std::ostream& out, ParamSet& p) {
+        Param all[MAX_PARAMS];
+        int count = list(p, all);
+        // Enough digits for the tuner's steps, without printing 0.1 as 0.10000000000000001.
+        out.precision(12);
+        out << "#ifndef HYPERSONIC_TUNEDPARAMS_H\n"
+            << "#define HYPERSONIC_TUNEDPARAMS_H\n\n"
+            << "#include \"Params.h\"\n\n"
+            << "// Generated by the tuner. Edit by hand, or rerun the tuner.\n";
+        const char* groups[] = {"bot.", "score.", "schedule."};
+        const char* declarations[] = {"static const BotFactors defaultBotFactors",
+                                      "static ScoreFactors defaultFactors",
+                                      "static const AnnealingSchedule defaultSchedule"};
+        for(int g = 0; g < 3; g++) {
+            int members[MAX_PARAMS];
+            int memberCount = 0;
+            for(int i = 0; i < count; i++) {
+                if(strncmp(all[i].name, groups[g], strlen(groups[g])) == 0) members[memberCount++] = i;
+            }
+            out << "\n" << declarations[g] << " = {\n";
+            for(int m = 0; m < memberCount; m++) {
+                const Param& param = all[members[m]];
+                out << "    " << *param.value << (m + 1 < memberCount ? "," : "")
+                    << "    // " << param.name + strlen(groups[g]) << "\n";
+            }
+            out << "};\n";
+        }
+        out << "\ninline ParamSet defaultParamSet() {\n"
+            << "    ParamSet p = {defaultBotFactors, defaultFactors, defaultSchedule};\n"
+            << "    return p;\n"
+            << "}\n\n"
+            << "#endif //HYPERSONIC_TUNEDPARAMS_H\n";
+    }
+};
+
+#endif //HYPERSONIC_PARAMS_H
@@ -0,0 +1,277 @@
+#ifndef HYPERSONIC_PARANOIDBOT_H
+#define HYPERSONIC_PARANOIDBOT_H
+
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <algorithm>
+
+#include "Board.h"
+#include "Mechanics.h"
+#include "Bot.h"
+#include "MoveOrdering.h"
+#include "SafeMoves.h"
+#include "MemoryArena.h"
+
+using namespace std;
+
+/* The replies considered for one opponent on one board, best first. */
+struct ReplySet {
+    static const int MAX_REPLIES = Position::DIR_COUNT * 2;
+    Move moves[MAX_REPLIES];
+    int count = 0;
+};
+
+/* Simultaneous move search against the nearest opponents.
+ * Our moves and the opponents' replies are applied together before each step. The opponents are treated as a
+ * coalition minimising our score (paranoid search), which turns the game into a two player search that alpha-beta
+ * can prune. Each opponent only gets a pruned set of replies: moves which don't kill it outright, ordered by how
+ * much they threaten us, cut to enemyMoveBudget. The reply sets depend only on the board, so they are cached per
+ * board hash for the turn. Opponents which are further away than opponentRadius, or beyond maxOpponents, stand
+ * still. The boards of the line being searched are a pool taken from the thread's arena for the move.
+ **/
+template<int MAX_DEPTH>
+class ParanoidBot {
+    static const int SURVIVAL_TURNS = 8;
+    static constexpr double DEATH_SCORE = -12000;
+    static constexpr double ENEMY_DANGER_SF = 100;
+    // Boards in use at each depth: our move, one per opponent's reply, and the step.
+    static const int NODE_SLOTS = Board::MAX_PLAYERS + 1;
+
+public:
+    int player;
+    int enemyMoveBudget = 3;
+    int maxOpponents = 1;
+    int opponentRadius = 8;
+    bool fight = false;
+    bool flee = false;
+    int fleeFrom = 0;
+    long long nodeCount = 0;
+    // The exhaustive search's weights, so the boxes are valued the same way.
+    BotFactors factors = defaultBotFactors;
+    // Shared history, killer and principal variation tables. Optional; without them moves are tried in a fixed
+    // order.
+    MoveOrdering* ordering = NULL;
+
+private:
+    int opponents[Board::MAX_PLAYERS];
+    int opponentCount = 0;
+    Move best;
+    double bestScore;
+    // Whether our moves so far are the ordering's principal variation, by depth.
+    bool followingPV[MAX_DEPTH + 2];
+    unordered_map<uint64_t, ReplySet> replyCache;
+    ArenaPool<Board> nodes;
+
+    Board& node(int depth, int slot) {
+        return nodes[depth * NODE_SLOTS + slot];
+    }
+
+    static bool canBomb(const Board& b, int p) {
+        return b.players[p].bombsAvailable > 0 && b.tiles[b.players[p].tile] != Board::BOMB;
+    }
+
+    static void apply(Board& b, int p, const Move& m) {
+        if(m.bomb) {
+            b.placeBomb(p);
+        }
+        b.move(p, m.dir);
+    }
+
+    void chooseOpponents(const Board& b) {
+        opponentCount = 0;
+        pair<int, int> byDist[Board::MAX_PLAYERS];
+        int count = 0;
+        for(int p = 0; p < b.playerCount; p++) {
+            if(p == player || !b.players[p].isAlive()) continue;
+            int d = Board::dist(b.players[p].tile, b.players[player].tile);
+            if(d <= opponentRadius) {
+                byDist[count++] = pair<int, int>(d, p);
+            }
+        }
+        // Insertion sort, nearest first, on at most three opponents.
+        for(int i = 1; i < count; i++) {
+            pair<int, int> o = byDist[i];
+            int j = i;
+            for(; j > 0 && o < byDist[j - 1]; j--) {
+                byDist[j] = byDist[j - 1];
+            }
+            byDist[j] = o;
+        }
+        for(int i = 0; i < count && i < maxOpponents; i++) {
+            opponents[opponentCount++] = byDist[i].second;
+        }
+    }
+
+    // Ranks every legal reply of the opponent by a cheap threat score: survive first, then how much it shrinks our
+    // escape, then how close it ends to us.
+    const ReplySet& replies(const Board& b, int opponent) {
+        uint64_t key = b.stateHash() * (Board::MAX_PLAYERS + 1) + opponent;
+        auto cached = replyCache.find(key);
+        if(cached != replyCache.end()) return cached->second;
+        ReplySet& set = replyCache[key];
+        double threat[ReplySet::MAX_REPLIES];
+        Move all[ReplySet::MAX_REPLIES];
+        int count = 0;
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            if(!b.canMove(opponent, d)) continue;
+            for(int bomb = 0; bomb <= 1; bomb++) {
+                if(bomb && !canBomb(b, opponent)) continue;
+                Board next = b;
+                Move m(d, bomb);
+                apply(next, opponent, m);
+                next.stepForward(1);
+                if(!next.players[opponent].isAlive()) continue;
+                double t = 0;
+                if(next.survivalTurns(opponent, SURVIVAL_TURNS) < SURVIVAL_TURNS) t -= 1000;
+                if(next.players[player].isAlive()) {
+                    t += 10 * (SURVIVAL_TURNS - next.survivalTurns(player, SURVIVAL_TURNS));
+                    t -= Board::dist(next.players[opponent].tile, next.players[player].tile);
+                } else {
+                    t += 1000;
+                }
+                threat[count] = t;
+                all[count++] = m;
+            }
+        }
+        // Selection sort, there are at most 10 replies.
+        for(int i = 0; i < count && set.count < enemyMoveBudget; i++) {
+            int top = i;
+            for(int j = i + 1; j < count; j++) {
+                if(threat[j] > threat[top]) top = j;
+            }
+            swap(threat[i], threat[top]);
+            swap(all[i], all[top]);
+            set.moves[set.count++] = all[i];
+        }
+        if(set.count == 0) {
+            // Every reply dies; it may as well stand still.
+            set.moves[set.count++] = Move(Position::NONE, false);
+        }
+        return set;
+    }
+
+    double evaluate(const Board& b, double curScore) {
+        double score = curScore;
+        int turnsLeftAlive = b.survivalTurns(player, SURVIVAL_TURNS);
+        if(turnsLeftAlive < SURVIVAL_TURNS) {
+            score += -1000 * (SURVIVAL_TURNS - turnsLeftAlive);
+        }
+        if(flee) {
+            return score + 10 * Board::dist(b.players[player].tile, fleeFrom) + b.players[player].bombsAvailable;
+        }
+        for(int i = 0; i < opponentCount; i++) {
+            int o = opponents[i];
+            int enemyTurns = b.players[o].isAlive() ? b.survivalTurns(o, SURVIVAL_TURNS) : 0;
+            score += ENEMY_DANGER_SF * (SURVIVAL_TURNS - enemyTurns);
+            if(fight && b.players[o].isAlive()) {
+                score -= Board::dist(b.players[player].tile, b.players[o].tile);
+            }
+        }
+        score += factors.powerupSF * (b.players[player].totalBombs + b.players[player].range);
+        score += factors.bombsAvailableSF * b.players[player].bombsAvailable;
+        for(int i = 0; i < Bomb::TIMEOUT; i++) {
+            score += factors.boxSF * b.scores(i)[player] * pow(factors.boxDepreciation, i + 1);
+        }
+        return score;
+    }
+
+    // Minimises over the joint replies of opponents [idx, opponentCount), with our move already applied to b.
+    // Replies are generated on the board before our move (before), as the opponents can't react to it within the
+    // turn.
+    double replyValue(const Board& before, const Board& b, int idx, int depth, double curScore, double alpha,
+                      double beta) {
+        if(idx == opponentCount) {
+            Board& next = node(depth, 1 + opponentCount);
+            next = b;
+            int beforeBoxCount = next.players[player].boxesDestroyed;
+            next.stepForward(1);
+            nodeCount++;
+            if(!next.players[player].isAlive()) return DEATH_SCORE;
+            double score = curScore + factors.boxSF * (next.players[player].boxesDestroyed - beforeBoxCount)
+                                      * pow(factors.boxDepreciation, depth);
+            if(depth == MAX_DEPTH) return evaluate(next, score);
+            return value(next, depth + 1, score, alpha, beta, NULL);
+        }
+        int o = opponents[idx];
+        if(!b.players[o].isAlive()) return replyValue(before, b, idx + 1, depth, curScore, alpha, beta);
+        const ReplySet& set = replies(before, o);
+        double worst = numeric_limits<double>::infinity();
+        for(int i = 0; i < set.count; i++) {
+            Board& next = node(depth, 1 + idx);
+            next = b;
+            if(set.moves[i].bomb && !canBomb(next, o)) continue;
+            if(!next.canMove(o, set.moves[i].dir)) continue;
+            apply(next, o, set.moves[i]);
+            worst = min(worst, replyValue(before, next, idx + 1, depth, curScore, alpha, beta));
+            beta = min(beta, worst);
+            if(worst <= alpha) break;
+        }
+        if(worst == numeric_limits<double>::infinity()) {
+            return replyValue(before, b, idx + 1, depth, curScore, alpha, beta);
+        }
+        return worst;
+    }
+
+    double value(const Board& b, int depth, double curScore, double alpha, double beta, Move* bestMove) {
+        Move moves[ReplySet::MAX_REPLIES];
+        int count = 0;
+        // Moves into certain death are left out, unless there are only those.
+        const int kinds = flee ? SafeMoves::NO_BOMB : SafeMoves::ALL;
+        int allowed = SafeMoves::survivable(b, player, 1) & kinds;
+        if(allowed == 0) allowed = SafeMoves::legal(b, player) & kinds;
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            for(int bomb = 1; bomb >= 0; bomb--) {
+                if(allowed & SafeMoves::bit(d, bomb)) moves[count++] = Move(d, bomb);
+            }
+        }
+        const int ply = depth - 1;
+        const int tile = b.players[player].tile;
+        if(ordering != NULL) ordering->order(ply, tile, followingPV[depth], moves, count);
+        double bestValue = -numeric_limits<double>::infinity();
+        for(int i = 0; i < count; i++) {
+            Board& next = node(depth, 0);
+            next = b;
+            const Move& m = moves[i];
+            apply(next, player, m);
+            followingPV[depth + 1] = followingPV[depth] && ordering != NULL && ordering->onPV(ply, m);
+            double v = replyValue(b, next, 0, depth, curScore, alpha, beta);
+            if(v > bestValue) {
+                bestValue = v;
+                if(bestMove != NULL) *bestMove = m;
+            }
+            alpha = max(alpha, bestValue);
+            if(bestValue >= beta) {
+                if(ordering != NULL) ordering->good(ply, tile, m, MAX_DEPTH - ply);
+                return bestValue;
+            }
+        }
+        // The root's best is the only move the search knows to be good without a cutoff.
+        if(ordering != NULL && bestMove != NULL && count > 0) ordering->good(ply, tile, *bestMove, MAX_DEPTH - ply);
+        return bestValue;
+    }
+
+public:
+    ParanoidBot(int player) : player(player) {}
+
+    pair<int, bool> move(Board b) {
+        replyCache.clear();
+        nodeCount = 0;
+        b.stepForward(1);
+        if(!b.players[player].isAlive()) return {Position::NONE, false};
+        MemoryArena& arena = MemoryArena::forThread();
+        ArenaScope scope(arena);
+        if(!nodes.init(arena, (MAX_DEPTH + 1) * NODE_SLOTS)) nodes.init((MAX_DEPTH + 1) * NODE_SLOTS);
+        chooseOpponents(b);
+        best = Move(Position::NONE, false);
+        followingPV[1] = true;
+        bestScore = value(b, 1, 0, -numeric_limits<double>::infinity(), numeric_limits<double>::infinity(), &best);
+        cerr << "Paranoid score: " << bestScore << "  opponents: " << opponentCount << "  nodes: " << nodeCount
+             << endl;
+        // The opponents' replies decide the rest of the line, so only our first move is known.
+        if(ordering != NULL) ordering->setPV(&best, 1);
+        return pair<int, bool>(best.dir, best.bomb);
+    }
+};
+
+#endif //HYPERSONIC_PARANOIDBOT_H
@@ -0,0 +1,133 @@
+#ifndef HYPERSONIC_PONDER_H
+#define HYPERSONIC_PONDER_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Board.h"
+#include "Sweep.h"
+#include "Heatmap.h"
+#include "TurnContext.h"
+#include "Territory.h"
+#include "MoveOrdering.h"
+#include "Simulation.h"
+#include "Bot.h"
+
+using namespace std;
+
+/* Searches the board we expect next while main waits for the referee's input.
+ * start() takes the board we expect to be given next turn, and the board to search (the same, with main's guesses
+ * for the enemies applied), and searches it on a worker thread. finish() takes the board which arrived. If it is
+ * the one expected, it waits for the search until a deadline and move() is the result; if not, or if the deadline
+ * passes first, the search is stopped and thrown away. The worker has its own heatmap, context, territory and move
+ * ordering, so it touches nothing main uses while it runs. Anything the bot reads through pointers (the enemy AI)
+ * must be left alone until finish() or cancel().
+ **/
+template<int DEPTH>
+class Ponder {
+    Bot<DEPTH> bot;
+    Heatmap heat;
+    TurnContext context;
+    Territory territory;
+    MoveOrdering ordering;
+    atomic<bool> stopFlag;
+    atomic<bool> done;
+    thread worker;
+    bool running = false;
+    uint64_t expectedKey = 0;
+    pair<int, bool> result;
+
+    void run(Board b) {
+        result = bot.move(b);
+        done = true;
+    }
+
+public:
+    long long hits = 0;
+    long long misses = 0;
+    // Hits whose search was stopped at the deadline.
+    long long late = 0;
+
+    Ponder(int player, const BotFactors& factors = defaultBotFactors) :
+            bot(player, factors), stopFlag(false), done(false) {
+        bot.setHeatmap(&heat);
+        bot.setContext(&context);
+        bot.setOrdering(&ordering);
+        bot.setTerritory(&territory);
+        bot.stop = &stopFlag;
+    }
+
+    ~Ponder() {
+        cancel();
+    }
+
+    // The searching bot, for its settings. Only while nothing is running.
+    Bot<DEPTH>& engine() {
+        return bot;
+    }
+
+    static long long getTimeMilli() {
+        return chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Boards as the referee gives them: destroyed boxes already settled.
+    static uint64_t key(const Board& b) {
+        Board settled = b;
+        Sweep::settleDestroyed(settled.tiles, Board::TILE_COUNT);
+        return settled.stateHash();
+    }
+
+    // current is the heatmap of this turn's board; a copy of it is synced to search.
+    void start(const Board& expected, const Board& search, const Heatmap& current) {
+        cancel();
+        expectedKey = key(expected);
+        heat = current;
+        heat.sync(search);
+        context.build(search);
+        territory.build(search);
+        ordering.newTurn();
+        stopFlag = false;
+        done = false;
+        running = true;
+        worker = thread(&Ponder::run, this, search);
+    }
+
+    // Whether actual is the board start() expected, and its search finished by deadline (in getTimeMilli() time).
+    // Otherwise the search is stopped, and move() isn't to be used.
+    bool finish(const Board& actual, long long deadline) {
+        if(!running) return false;
+        if(key(actual) != expectedKey) {
+            cancel();
+            misses++;
+            return false;
+        }
+        hits++;
+        while(!done && getTimeMilli() < deadline) {
+            this_thread::sleep_for(chrono::microseconds(200));
+        }
+        if(!done) {
+            cancel();
+            late++;
+            return false;
+        }
+        worker.join();
+        running = false;
+        return true;
+    }
+
+    void cancel() {
+        if(!running) return;
+        stopFlag = true;
+        worker.join();
+        running = false;
+    }
+
+    // The pondered move, after a hit.
+    pair<int, bool> move() const {
+        return result;
+    }
+};
+
+#endif //HYPERSONIC_PONDER_H
@@ -0,0 +1,93 @@
+#ifndef HYPERSONIC_REGIONBOT_H
+#define HYPERSONIC_REGIONBOT_H
+
+#include <bitset>
+
+#include "Board.h"
+#include "TurnContext.h"
+#include "BeamBot.h"
+
+using namespace std;
+
+/* Search for when no opponent can reach us, so all that's left is clearing the boxes around us in the best order.
+ * extract() reduces the board to our region: the free tiles we can walk to (through bombs and boxes being destroyed,
+ * which clear), and the boxes on its border which our bombs can open it up through. Everything else becomes wall,
+ * except bombs (which keep their timeline, so blasts into the region are still seen), and the other players are
+ * removed. The reduced board has few states, so a beam over it reaches much deeper than the full board search,
+ * without simulating any enemies.
+ **/
+class RegionBot {
+public:
+    static const int DEFAULT_TIME = 60;
+    static const int WIDTH = 300;
+
+    int regionSize = 0;
+    int depthReached = 0;
+
+private:
+    int player;
+    BeamBot beam;
+    TurnContext context;
+
+public:
+    RegionBot(int player, long allocatedTimeMilli = DEFAULT_TIME, int beamWidth = WIDTH) :
+            player(player), beam(player, allocatedTimeMilli, beamWidth) {
+        beam.setContext(&context);
+    }
+
+    // The board reduced to player's region, and the region's size in tiles.
+    static Board extract(const Board& b, int player, int* size) {
+        bitset<Board::TILE_COUNT> region;
+        bitset<Board::TILE_COUNT> border;
+        int queue[Board::TILE_COUNT];
+        int qIn = 0;
+        int qOut = 0;
+        const int start = b.players[player].tile;
+        region.set(start);
+        queue[qIn++] = start;
+        while(qOut < qIn) {
+            int t = queue[qOut++];
+            for(int j = 0; j < Board::grid.neighbourCount[t]; j++) {
+                int n = Board::grid.neighbours[t][j];
+                if(region[n]) continue;
+                // Bombs and the boxes being destroyed are walls for now, but part of the region once they clear.
+                if(b.isFree(n) || b.tiles[n] == Board::BOMB || b.isDestroyedBox(n)) {
+                    region.set(n);
+                    queue[qIn++] = n;
+                } else if(b.isBox(n)) {
+                    border.set(n);
+                }
+            }
+        }
+        Board sub = b;
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(region[t] || border[t] || sub.tiles[t] == Board::BOMB) continue;
+            sub.tiles[t] = Board::WALL;
+        }
+        for(int p = 0; p < Board::MAX_PLAYERS; p++) {
+            if(p == player) continue;
+            sub.players[p] = Player();
+            sub.players[p].range = 0;
+            sub.players[p].totalBombs = 0;
+            sub.players[p].bombsAvailable = 0;
+        }
+        *size = qIn;
+        return sub;
+    }
+
+    pair<int, bool> move(const Board& b) {
+        Board sub = extract(b, player, &regionSize);
+        context.build(sub);
+        pair<int, bool> m = beam.move(sub);
+        depthReached = beam.depthReached;
+        cerr << "Region: " << regionSize << " tiles, depth " << depthReached << endl;
+        return m;
+    }
+
+    // The best line found by the last move().
+    const BeamBot& search() const {
+        return beam;
+    }
+};
+
+#endif //HYPERSONIC_REGIONBOT_H
@@ -0,0 +1,89 @@
+#ifndef HYPERSONIC_SAFEMOVES_H
+#define HYPERSONIC_SAFEMOVES_H
+
+#include "Board.h"
+#include "Simulation.h"
+#include "TimePath.h"
+
+using namespace std;
+
+/* Move generation with the suicidal moves filtered out, as a bitmask over (direction, bomb).
+ * A move survives k turns if, on the board's explosion timeline (with our bomb placed, for bomb moves), some walk
+ * from the tile it moves to avoids every explosion for the next k steps. The walk may use any free tile, and boxes
+ * and bombs once an explosion has cleared them; other players don't block. Other players' bombs only add
+ * explosions, so a move which fails with k = 1 is certain death. For larger k it is a strong hint rather than a
+ * proof: a bomb placed later can chain an existing bomb earlier, which frees the tiles it would have exploded.
+ * Call it on the board the move is played on, before the step (as the searches do).
+ **/
+class SafeMoves {
+public:
+    static const int MOVE_KINDS = Position::DIR_COUNT * 2;
+    static const int ALL = (1 << MOVE_KINDS) - 1;
+    // The moves without a bomb: the even bits.
+    static const int NO_BOMB = 0x155;
+
+    static int bit(int dir, bool bomb) {
+        return 1 << (dir * 2 + (bomb ? 1 : 0));
+    }
+
+    static bool allows(int mask, const Move& m) {
+        return (mask & bit(m.dir, m.bomb)) != 0;
+    }
+
+    static bool canBomb(const Board& b, int player) {
+        return b.players[player].bombsAvailable > 0 && b.tiles[b.players[player].tile] != Board::BOMB;
+    }
+
+    // Moves the board allows.
+    static int legal(const Board& b, int player) {
+        if(!b.players[player].isAlive()) return 0;
+        const bool bomb = canBomb(b, player);
+        int mask = 0;
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            if(!b.canMove(player, d)) continue;
+            mask |= bit(d, false);
+            if(bomb) mask |= bit(d, true);
+        }
+        return mask;
+    }
+
+    // The legal moves after which player can live through the next k steps (at most Bomb::TIMEOUT).
+    static int survivable(const Board& b, int player, int k) {
+        const int legalMask = legal(b, player);
+        if(k > Bomb::TIMEOUT) k = Bomb::TIMEOUT;
+        int mask = survivors(b, player, k, false, legalMask);
+        if(canBomb(b, player) && legalMask != 0) {
+            Board bombed = b;
+            bombed.placeBomb(player);
+            mask |= survivors(bombed, player, k, true, legalMask);
+        }
+        return mask;
+    }
+
+private:
+    static int survivors(const Board& b, int player, int k, bool bomb, int legalMask) {
+        int mask = 0;
+        const int from = b.players[player].tile;
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            if(!(legalMask & bit(d, bomb))) continue;
+            if(escapes(b, Board::adjTile(from, d), k)) mask |= bit(d, bomb);
+        }
+        return mask;
+    }
+
+    // Whether some walk from tile, which is where the player is for the first step, avoids the timeline's
+    // explosions for k steps.
+    static bool escapes(const Board& b, int tile, int k) {
+        if(b.explodes(0)[tile]) return false;
+        TimePath::Tiles reach;
+        TimePath::Tiles opened;
+        reach.set(tile);
+        for(int s = 1; s < k; s++) {
+            reach = TimePath::advance(b, s, reach, opened);
+            if(reach.none()) return false;
+        }
+        return true;
+    }
+};
+
+#endif //HYPERSONIC_SAFEMOVES_H
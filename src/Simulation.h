@@ -0,0 +1,176 @@
+#ifndef HYPERSONIC_SIMULATION_H
+#define HYPERSONIC_SIMULATION_H
+
+#include <cmath>
+
+#include "Board.h"
+#include "TunedParams.h"
+
+using namespace std;
+
+struct Move {
+    int dir;
+    bool bomb;
+
+    Move() {}
+
+    Move(int dir, bool bomb) : dir(dir), bomb(bomb) {}
+};
+
+class SimBot {
+public:
+    virtual Move move(Board& b) = 0;
+    virtual void setTurn(int turn) {};
+    virtual int player() = 0;
+};
+
+class MinimalBot: public SimBot {
+    int player_;
+
+public:
+    MinimalBot() {}
+    MinimalBot(int player) : player_(player) {}
+
+    Move move(Board& b) {
+        return Move(Position::Dir::NONE, false);
+    }
+
+    int player() {
+        return player_;
+    }
+};
+
+class CustomAI : public SimBot {
+    const Move* moves;
+    int turn = 0;
+    int player_;
+
+public:
+    CustomAI(int player, const Move moves[], int startFromTurn) :
+            player_(player), moves(moves), turn(startFromTurn) {}
+
+    void setTurn(int fromTurn) {
+        turn = fromTurn;
+    }
+
+    Move move(Board& b) {
+        return moves[turn++];
+    }
+
+    int player() {
+        return player_;
+    }
+};
+
+/* Simulation core shared by the plan based bots (AnnealingBot, EvolutionBot).
+ * Plays a plan for us against the enemy SimBots for TURNS turns, keeping every intermediate board in simHistory,
+ * and scores the result.
+ **/
+template<int TURNS, int PLAYERS>
+class Simulation {
+public:
+    ScoreFactors sFactors = defaultFactors;
+    static constexpr double INVALID_PLAN_PENALTY = 10000;
+
+protected:
+    int player;
+    SimBot **enemyBots;
+    Board simHistory[TURNS + 1];
+
+public:
+    Simulation() {}
+
+    Simulation(int player) : player(player) {}
+
+    void setEnemyAI(SimBot* enemyAI[]) {
+        enemyBots = enemyAI;
+    }
+
+    // Use sim history
+    double score() {
+        const Board& endBoard = simHistory[TURNS];
+        const Board& startBoard = simHistory[0];
+        double score = 0;
+        // Victory & Defeat
+        // Should be broken up to determine the placing. 3rd is better than 4th.
+        if(!endBoard.players[player].isAlive()) {
+            return sFactors.defeat;
+        } else if(endBoard.aliveCount == 1) {
+            // Only player left is us.
+            return  sFactors.victory;
+        } else {
+            score += (endBoard.playerCount - endBoard.aliveCount) * sFactors.enemyDeath;
+        }
+
+        // Continued survival
+        int turnsLeftAlive = endBoard.survivalTurns(player, Bomb::TIMEOUT);
+        if(turnsLeftAlive < Bomb::TIMEOUT) {
+            return sFactors.defeat * (Bomb::TIMEOUT - turnsLeftAlive) / Bomb::TIMEOUT;
+        }
+
+        // Box counts
+        // Haven't yet given any depreciation to the pre-survival box counts.
+        int beforeBoxCount = startBoard.players[player].boxesDestroyed;
+        int afterBoxCount = endBoard.players[player].boxesDestroyed;
+        score += (afterBoxCount - beforeBoxCount) * sFactors.boxesDestroyed;
+
+        for(int i = 0; i < Bomb::TIMEOUT; i++) {
+            score += sFactors.boxesDestroyed * endBoard.scores(i)[player] * pow(sFactors.boxDepreciation, i + 1);
+        }
+        return score;
+    }
+
+    int simulate(SimBot* ourSim, SimBot* enemySims[], int startFromTurn) {
+        // Assuming the board has had stepForward called for the very first board.
+        Move m;
+        for(int i = startFromTurn; i < TURNS; i++) {
+            simHistory[i+1]  = simHistory[i];
+            // Us move first? Place our bomb first?
+            if(simHistory[i+1].players[player].isAlive()) {
+                m = ourSim->move(simHistory[i + 1]);
+                if(simHistory[i+1].canMove(player, m.dir)) {
+                    if(m.bomb) {
+                        simHistory[i+1].placeBomb(player);
+                    }
+                    simHistory[i+1].move(player, m.dir);
+                } else {
+                    return i;
+                }
+            }
+            for(int p = 0; p < PLAYERS - 1; p++) {
+                int enemy = enemySims[p]->player();
+                if(simHistory[i+1].players[enemy].isAlive()) {
+                    m = enemySims[p]->move(simHistory[i+1]);
+                    if(simHistory[i+1].canMove(enemy, m.dir)) {
+                        if(m.bomb) {
+                            simHistory[i+1].placeBomb(enemy);
+                        }
+                        simHistory[i+1].move(enemy, m.dir);
+                    } else {
+                        simHistory[i+1].move(enemy, Position::Dir::NONE);
+                    }
+                }
+            }
+            simHistory[i+1].stepForward(1);
+        }
+        return TURNS-1;
+    }
+
+    // Lower is better, for minimisation by the annealer.
+    double score(const Move solution[], int startFromTurn) {
+        CustomAI customAI(player, solution, startFromTurn);
+        for(int i = 0; i < PLAYERS - 1; i++) {
+            enemyBots[i]->setTurn(startFromTurn);
+        }
+        int validUntil = simulate(&customAI, enemyBots, startFromTurn);
+        if(validUntil < (TURNS - 1)) {
+            return INVALID_PLAN_PENALTY;
+        }
+        return -score();
+    }
+};
+
+template<int TURNS, int PLAYERS>
+constexpr double Simulation<TURNS, PLAYERS>::INVALID_PLAN_PENALTY;
+
+#endif //HYPERSONIC_SIMULATION_H
@@ -0,0 +1,107 @@
+#ifndef HYPERSONIC_SWEEP_H
+#define HYPERSONIC_SWEEP_H
+
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/* Whole-row tile sweeps for Board::stepForward, 32 (AVX2) or 16 (SSE2) tiles at a time, with a scalar loop for
+ * the tail and for targets without either.
+ **/
+struct Sweep {
+    // Tile characters, repeated from Board (which includes this).
+    static const char DESTROYED = '3';
+    static const char RANGE_DESTROYED = '4';
+    static const char COUNT_DESTROYED = '5';
+    static const char EMPTY = '.';
+    static const char RANGE_PU = 'r';
+    static const char COUNT_PU = 'c';
+
+    static inline char settled(char tile) {
+        return tile == DESTROYED ? EMPTY
+             : tile == RANGE_DESTROYED ? RANGE_PU
+             : tile == COUNT_DESTROYED ? COUNT_PU
+             : tile;
+    }
+
+    // Destroyed boxes become empty tiles, or the power-up they held.
+    static void settleDestroyed(char tiles[], int count) {
+        int i = 0;
+#if defined(__AVX2__)
+        const __m256i d0 = _mm256_set1_epi8(DESTROYED);
+        const __m256i d1 = _mm256_set1_epi8(RANGE_DESTROYED);
+        const __m256i d2 = _mm256_set1_epi8(COUNT_DESTROYED);
+        const __m256i e0 = _mm256_set1_epi8(EMPTY);
+        const __m256i e1 = _mm256_set1_epi8(RANGE_PU);
+        const __m256i e2 = _mm256_set1_epi8(COUNT_PU);
+        for(; i + 32 <= count; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (tiles + i));
+            __m256i m0 = _mm256_cmpeq_epi8(v, d0);
+            __m256i m1 = _mm256_cmpeq_epi8(v, d1);
+            __m256i m2 = _mm256_cmpeq_epi8(v, d2);
+            if(_mm256_testz_si256(_mm256_or_si256(m0, _mm256_or_si256(m1, m2)), _mm256_set1_epi8(-1))) continue;
+            v = _mm256_blendv_epi8(v, e0, m0);
+            v = _mm256_blendv_epi8(v, e1, m1);
+            v = _mm256_blendv_epi8(v, e2, m2);
+            _mm256_storeu_si256((__m256i*) (tiles + i), v);
+        }
+#elif defined(__SSE2__)
+        const __m128i d0 = _mm_set1_epi8(DESTROYED);
+        const __m128i d1 = _mm_set1_epi8(RANGE_DESTROYED);
+        const __m128i d2 = _mm_set1_epi8(COUNT_DESTROYED);
+        const __m128i e0 = _mm_set1_epi8(EMPTY);
+        const __m128i e1 = _mm_set1_epi8(RANGE_PU);
+        const __m128i e2 = _mm_set1_epi8(COUNT_PU);
+        for(; i + 16 <= count; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*) (tiles + i));
+            __m128i m0 = _mm_cmpeq_epi8(v, d0);
+            __m128i m1 = _mm_cmpeq_epi8(v, d1);
+            __m128i m2 = _mm_cmpeq_epi8(v, d2);
+            __m128i any = _mm_or_si128(m0, _mm_or_si128(m1, m2));
+            if(_mm_movemask_epi8(any) == 0) continue;
+            // No blendv before SSE4.1: keep the other bytes, and or in the replacements.
+            v = _mm_andnot_si128(any, v);
+            v = _mm_or_si128(v, _mm_and_si128(m0, e0));
+            v = _mm_or_si128(v, _mm_and_si128(m1, e1));
+            v = _mm_or_si128(v, _mm_and_si128(m2, e2));
+            _mm_storeu_si128((__m128i*) (tiles + i), v);
+        }
+#endif
+        for(; i < count; i++) {
+            tiles[i] = settled(tiles[i]);
+        }
+    }
+
+    // Writes the indices of the set entries of row to out, in increasing order. Returns how many there are.
+    static int setIndices(const bool row[], int count, int out[]) {
+        int n = 0;
+        int i = 0;
+#if defined(__AVX2__)
+        for(; i + 32 <= count; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (row + i));
+            uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpgt_epi8(v, _mm256_setzero_si256()));
+            while(mask) {
+                out[n++] = i + __builtin_ctz(mask);
+                mask &= mask - 1;
+            }
+        }
+#elif defined(__SSE2__)
+        for(; i + 16 <= count; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*) (row + i));
+            uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_setzero_si128()));
+            while(mask) {
+                out[n++] = i + __builtin_ctz(mask);
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for(; i < count; i++) {
+            if(row[i]) out[n++] = i;
+        }
+        return n;
+    }
+};
+
+#endif //HYPERSONIC_SWEEP_H
@@ -0,0 +1,184 @@
+#ifndef HYPERSONIC_TERRITORY_H
+#define HYPERSONIC_TERRITORY_H
+
+#include <bitset>
+#include <cstring>
+
+#include "Board.h"
+
+using namespace std;
+
+/* The tiles and boxes each player can reach before anyone else, and when, over the explosion timeline.
+ * Each player's walk is flooded a step at a time with bitset shifts, as TimePath walks it: free tiles, and the
+ * tiles explosions have cleared, but never a tile as it explodes. A box is reached when a tile next to it is.
+ * Players don't block each other, so a player is first to a tile when their walk gets there in fewer steps than
+ * every other player's; ties are nobody's. Only boxes no bomb is going to destroy yet (targets) count.
+ * Built once a turn, after InputParser::update. Inside a search only our own walk moves far enough to matter, so
+ * ownedBoxes() floods just our player on the leaf and compares it with the other players' walks from the turn's
+ * board.
+ **/
+class Territory {
+public:
+    typedef bitset<Board::TILE_COUNT> Tiles;
+    static const int HORIZON = 24;
+    static const int NEVER = 255;
+
+private:
+    // Steps each player's walk takes to each tile, or NEVER within HORIZON.
+    unsigned char arrivals[Board::MAX_PLAYERS][Board::TILE_COUNT];
+    // The fewest steps any other player takes.
+    unsigned char others[Board::MAX_PLAYERS][Board::TILE_COUNT];
+    Tiles firstTiles[Board::MAX_PLAYERS];
+    Tiles firstBoxes[Board::MAX_PLAYERS];
+    Tiles targets;
+    int targetTotal = 0;
+    int turn = 0;
+
+    struct Columns {
+        Tiles notFirst;
+        Tiles notLast;
+        Columns() {
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                if(t % Board::WIDTH != 0) notFirst.set(t);
+                if(t % Board::WIDTH != Board::WIDTH - 1) notLast.set(t);
+            }
+        }
+    };
+
+    static const Columns& columns() {
+        static const Columns c;
+        return c;
+    }
+
+    // The tiles next to any in s.
+    static Tiles spread(const Tiles& s) {
+        const Columns& c = columns();
+        return ((s << 1) & c.notFirst) | ((s >> 1) & c.notLast) | (s << Board::WIDTH) | (s >> Board::WIDTH);
+    }
+
+    static bool scheduled(const Board& b, int tile) {
+        for(int k = 0; k < Bomb::TIMEOUT; k++) {
+            if(b.explodes(k)[tile]) return true;
+        }
+        return false;
+    }
+
+    static Tiles walkable(const Board& b) {
+        Tiles w;
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(b.isFree(t) || b.isDestroyedBox(t)) w.set(t);
+        }
+        return w;
+    }
+
+    // Fills out with the steps the walk from start takes to each tile.
+    static void flood(const Board& b, const Tiles& free, int start, unsigned char out[]) {
+        memset(out, NEVER, Board::TILE_COUNT);
+        out[start] = 0;
+        Tiles reach;
+        reach.set(start);
+        Tiles seen = reach;
+        Tiles opened;
+        Tiles exploding;
+        for(int s = 0; s < HORIZON; s++) {
+            // What exploded in the last step is passable now.
+            opened |= exploding;
+            exploding.reset();
+            if(s < Bomb::TIMEOUT) {
+                const bool* e = b.explodes(s);
+                for(int t = 0; t < Board::TILE_COUNT; t++) {
+                    if(e[t]) exploding.set(t);
+                }
+            }
+            Tiles next = (reach | (spread(reach) & (free | opened))) & ~exploding;
+            Tiles fresh = next & ~seen;
+            for(size_t t = fresh._Find_first(); t < Board::TILE_COUNT; t = fresh._Find_next(t)) {
+                out[t] = (unsigned char) (s + 1);
+            }
+            seen |= fresh;
+            // Nothing left to wait for, and nowhere new to go.
+            if(next.none() || (s >= Bomb::TIMEOUT && fresh.none())) return;
+            reach = next;
+        }
+    }
+
+    // The fewest steps to a tile next to box, by the arrivals in steps.
+    static int boxArrival(const unsigned char steps[], int box) {
+        int best = NEVER;
+        for(int j = 0; j < Board::grid.neighbourCount[box]; j++) {
+            int n = Board::grid.neighbours[box][j];
+            if(steps[n] < best) best = steps[n];
+        }
+        return best;
+    }
+
+public:
+    void build(const Board& b) {
+        turn = b.turn;
+        targets.reset();
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(b.isBox(t) && !scheduled(b, t)) targets.set(t);
+        }
+        targetTotal = (int) targets.count();
+        const Tiles free = walkable(b);
+        for(int p = 0; p < Board::MAX_PLAYERS; p++) {
+            if(p < b.playerCount && b.players[p].isAlive()) {
+                flood(b, free, b.players[p].tile, arrivals[p]);
+            } else {
+                memset(arrivals[p], NEVER, Board::TILE_COUNT);
+            }
+        }
+        for(int p = 0; p < Board::MAX_PLAYERS; p++) {
+            memset(others[p], NEVER, Board::TILE_COUNT);
+            for(int q = 0; q < Board::MAX_PLAYERS; q++) {
+                if(q == p) continue;
+                for(int t = 0; t < Board::TILE_COUNT; t++) {
+                    if(arrivals[q][t] < others[p][t]) others[p][t] = arrivals[q][t];
+                }
+            }
+            firstTiles[p].reset();
+            firstBoxes[p].reset();
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                if(arrivals[p][t] < others[p][t]) firstTiles[p].set(t);
+            }
+            for(size_t t = targets._Find_first(); t < Board::TILE_COUNT; t = targets._Find_next(t)) {
+                if(boxArrival(arrivals[p], t) < boxArrival(others[p], t)) firstBoxes[p].set(t);
+            }
+        }
+    }
+
+    // Steps player's walk takes to tile, or -1 if it doesn't get there within HORIZON.
+    int arrival(int player, int tile) const {
+        return arrivals[player][tile] == NEVER ? -1 : arrivals[player][tile];
+    }
+
+    const Tiles& tilesFirst(int player) const {
+        return firstTiles[player];
+    }
+
+    const Tiles& boxesFirst(int player) const {
+        return firstBoxes[player];
+    }
+
+    // The targets on the turn's board. Boxes only disappear, so no leaf owns more.
+    int targetCount() const {
+        return targetTotal;
+    }
+
+    // The turn's targets which are still targets on leaf, a later board of the turn, and which player gets next to
+    // before the other players would have from the turn's board. Steps count from the turn's board.
+    int ownedBoxes(const Board& leaf, int player) const {
+        unsigned char steps[Board::TILE_COUNT];
+        flood(leaf, walkable(leaf), leaf.players[player].tile, steps);
+        const int elapsed = leaf.turn - turn;
+        int count = 0;
+        for(size_t t = targets._Find_first(); t < Board::TILE_COUNT; t = targets._Find_next(t)) {
+            if(!leaf.isBox(t) || scheduled(leaf, t)) continue;
+            int ours = boxArrival(steps, t);
+            if(ours != NEVER && ours + elapsed < boxArrival(others[player], t)) count++;
+        }
+        return count;
+    }
+};
+
+#endif //HYPERSONIC_TERRITORY_H
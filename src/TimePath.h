@@ -0,0 +1,118 @@
+#ifndef HYPERSONIC_TIMEPATH_H
+#define HYPERSONIC_TIMEPATH_H
+
+#include <bitset>
+
+#include "Board.h"
+
+using namespace std;
+
+/* Earliest arrival at any of a set of target tiles, over the board's explosion timeline.
+ * A breadth first search over (tile, step) states, a layer of tiles per step, so boxes and bombs become passable
+ * the step after an explosion clears them, and no walk is ever on a tile as it explodes. Waiting is a move, so a
+ * walk can stand clear of a blast and go through once it has passed. Other players don't block, and only the bombs
+ * already on the board explode; past the timeline (Bomb::TIMEOUT steps) the layout no longer changes, and the
+ * search stops once the layer stops growing. Call it on the board the move is played on, before the step (as the
+ * searches do).
+ **/
+class TimePath {
+public:
+    typedef bitset<Board::TILE_COUNT> Tiles;
+    static const int HORIZON = 32;
+    static const int UNREACHABLE = -1;
+
+    // Moves to the target found by the last search, or UNREACHABLE.
+    int arrival = UNREACHABLE;
+    int target = Board::INVALID_TILE;
+
+private:
+    // Where the walk was before move s, for each tile reached by it.
+    short from[HORIZON][Board::TILE_COUNT];
+    int tiles[HORIZON + 1];
+
+    static int dirBetween(int a, int b) {
+        for(int d = Position::RIGHT; d <= Position::NONE; d++) {
+            if(Board::adjTile(a, d) == b) return d;
+        }
+        return Position::NONE;
+    }
+
+public:
+    // The tiles a walk can be on after move s, from the tiles it could be on before it. opened collects the tiles
+    // explosions have cleared, and is brought up to date for s. If parents isn't NULL, each tile reached records
+    // the tile it was reached from.
+    static Tiles advance(const Board& b, int s, const Tiles& reach, Tiles& opened, short* parents = NULL) {
+        // What exploded in the last step is passable now (boxes a step early, which only errs towards safe).
+        if(s > 0 && s <= Bomb::TIMEOUT) {
+            const bool* exploded = b.explodes(s - 1);
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                if(exploded[t]) opened.set(t);
+            }
+        }
+        static const bool NONE_EXPLODING[Board::TILE_COUNT] = {false};
+        const bool* exploding = s < Bomb::TIMEOUT ? b.explodes(s) : NONE_EXPLODING;
+        Tiles next;
+        for(size_t t = reach._Find_first(); t < Board::TILE_COUNT; t = reach._Find_next(t)) {
+            // Staying put is always allowed, on a bomb too.
+            if(!exploding[t] && !next[t]) {
+                next.set(t);
+                if(parents != NULL) parents[t] = (short) t;
+            }
+            for(int j = 0; j < Board::grid.neighbourCount[t]; j++) {
+                int n = Board::grid.neighbours[t][j];
+                if(next[n] || exploding[n] || b.tiles[n] == Board::WALL) continue;
+                if(b.isFree(n) || b.isDestroyedBox(n) || opened[n]) {
+                    next.set(n);
+                    if(parents != NULL) parents[n] = (short) t;
+                }
+            }
+        }
+        return next;
+    }
+
+    // Searches from start for the first step any target can be stood on, within horizon moves. Returns arrival.
+    int search(const Board& b, int start, const Tiles& targets, int horizon = HORIZON) {
+        arrival = UNREACHABLE;
+        target = Board::INVALID_TILE;
+        if(horizon > HORIZON) horizon = HORIZON;
+        tiles[0] = start;
+        if(targets[start]) {
+            arrival = 0;
+            target = start;
+            return arrival;
+        }
+        Tiles reach;
+        Tiles opened;
+        reach.set(start);
+        for(int s = 0; s < horizon; s++) {
+            Tiles next = advance(b, s, reach, opened, from[s]);
+            Tiles hit = next & targets;
+            if(hit.any()) {
+                arrival = s + 1;
+                target = (int) hit._Find_first();
+                break;
+            }
+            // Nothing left to wait for, and nowhere new to go.
+            if(next.none() || (s >= Bomb::TIMEOUT && next == reach)) return arrival;
+            reach = next;
+        }
+        if(arrival == UNREACHABLE) return arrival;
+        tiles[arrival] = target;
+        for(int s = arrival - 1; s > 0; s--) {
+            tiles[s] = from[s][tiles[s + 1]];
+        }
+        return arrival;
+    }
+
+    // The tile the last search's path is on after i moves, for i up to arrival.
+    int tileAt(int i) const {
+        return tiles[i];
+    }
+
+    // The direction of move i of the last search's path, for i below arrival.
+    int moveAt(int i) const {
+        return dirBetween(tiles[i], tiles[i + 1]);
+    }
+};
+
+#endif //HYPERSONIC_TIMEPATH_H
@@ -0,0 +1,43 @@
+#ifndef HYPERSONIC_TUNEDPARAMS_H
+#define HYPERSONIC_TUNEDPARAMS_H
+
+#include "Params.h"
+
+// Generated by the tuner. Edit by hand, or rerun the tuner.
+
+static const BotFactors defaultBotFactors = {
+    1,    // boxSF
+    0.875,    // boxDepreciation
+    0.1,    // powerupSF
+    0.125,    // bombsAvailableSF
+    0.005,    // closestSF
+    0.01,    // heatSF
+    0    // territorySF
+};
+
+static ScoreFactors defaultFactors = {
+    1,    // boxesDestroyed
+    0.875,    // boxDepreciation
+    0.1,    // rangePU
+    0.1,    // countPU
+    50,    // enemyDeath
+    200,    // victory
+    -200    // defeat
+};
+
+static const AnnealingSchedule defaultSchedule = {
+    23000,    // initTemp
+    0.95,    // initCoolingFraction
+    0.96,    // startAcceptanceRate
+    1e-11,    // endAcceptanceRate
+    1.3,    // stepsVsCoolRatio
+    160,    // initCoolingSteps
+    140    // initStepsPerTemp
+};
+
+inline ParamSet defaultParamSet() {
+    ParamSet p = {defaultBotFactors, defaultFactors, defaultSchedule};
+    return p;
+}
+
+#endif //HYPERSONIC_TUNEDPARAMS_H
@@ -0,0 +1,188 @@
+#ifndef HYPERSONIC_TUNER_H
+#define HYPERSONIC_TUNER_H
+
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+#include "Params.h"
+#include "TunedParams.h"
+#include "Match.h"
+
+using namespace std;
+
+struct TunerConfig {
+    enum Engine {EXHAUSTIVE, ANNEALING};
+    Engine engine = EXHAUSTIVE;
+    // Games per SPSA iteration, split over the workers.
+    int games = 8;
+    int workers = 1;
+    int maxTurns = Match::MAX_TURNS;
+    long annealingTimeMilli = 20;
+    // SPSA gains, in the normalised [0, 1] parameter space.
+    double a = 0.1;
+    double c = 0.1;
+    double stabilityConstant = 10;
+    unsigned int seed = 1;
+};
+
+/* Offline parameter tuning by self-play (SPSA).
+ * Each iteration perturbs every tuned parameter at once by +-c_k, plays the plus set against the minus set, and
+ * steps along the estimated gradient of the win rate. Only the parameters the chosen engine reads are tuned. The
+ * parameters are normalised by their Param range, so a single gain suits all of them.
+ * The games run on worker threads. A game's state is all in its own boards, bots and players, so games share
+ * nothing but read only tables (and Board::paths, which is per thread).
+ **/
+class Tuner {
+public:
+    static const int MAX_WORKERS = 64;
+    ParamSet current;
+    int iteration = 0;
+
+private:
+    TunerConfig config;
+    Param params[Params::MAX_PARAMS];
+    int tuned[Params::MAX_PARAMS];
+    int tunedCount = 0;
+
+    static double clamp01(double x) {
+        return x < 0 ? 0 : x > 1 ? 1 : x;
+    }
+
+    bool isTuned(const Param& p) const {
+        if(config.engine == TunerConfig::EXHAUSTIVE) return strncmp(p.name, "bot.", 4) == 0;
+        return strncmp(p.name, "score.", 6) == 0 || strncmp(p.name, "schedule.", 9) == 0;
+    }
+
+    double normalised(int i) const {
+        const Param& p = params[tuned[i]];
+        return (*p.value - p.min) / (p.max - p.min);
+    }
+
+    // Writes theta back through view, a Params::list of the set to change.
+    void denormalise(const double theta[], Param view[]) const {
+        for(int i = 0; i < tunedCount; i++) {
+            Param& p = view[tuned[i]];
+            *p.value = p.min + clamp01(theta[i]) * (p.max - p.min);
+        }
+    }
+
+    MatchPlayer* makePlayer(int player, const ParamSet& p) const {
+        if(config.engine == TunerConfig::EXHAUSTIVE) return new BotPlayer<4>(player, p);
+        return new AnnealingPlayer(player, 1 - player, p, config.annealingTimeMilli);
+    }
+
+    // +1 if a won, -1 if b won. a plays first in even games, so both sides of every map are played.
+    int playGame(const ParamSet& a, const ParamSet& b, int game, unsigned int seed) const {
+        bool aFirst = game % 2 == 0;
+        MatchPlayer* first = makePlayer(0, aFirst ? a : b);
+        MatchPlayer* second = makePlayer(1, aFirst ? b : a);
+        MatchResult r = Match::play(first, second, seed + game / 2, config.maxTurns);
+        delete first;
+        delete second;
+        if(r.winner == MatchResult::DRAW) return 0;
+        return (r.winner == 0) == aFirst ? 1 : -1;
+    }
+
+    int playSlice(const ParamSet& a, const ParamSet& b, int worker, int workers, unsigned int seed) const {
+        int sum = 0;
+        for(int g = worker; g < config.games; g += workers) {
+            sum += playGame(a, b, g, seed);
+        }
+        return sum;
+    }
+
+    void playSliceInto(const ParamSet& a, const ParamSet& b, int worker, int workers, unsigned int seed,
+                       int* out) const {
+        *out = playSlice(a, b, worker, workers, seed);
+    }
+
+public:
+    Tuner(const TunerConfig& config, const ParamSet& start) : current(start), config(config) {
+        int count = Params::list(current, params);
+        for(int i = 0; i < count; i++) {
+            if(isTuned(params[i])) tuned[tunedCount++] = i;
+        }
+    }
+
+    int tunedParams() const {
+        return tunedCount;
+    }
+
+    // Sum over the games of +1 for a win of a, -1 for a win of b.
+    int playGames(const ParamSet& a, const ParamSet& b, unsigned int seed) const {
+        int workers = min(config.workers, config.games);
+        if(workers > MAX_WORKERS) workers = MAX_WORKERS;
+        int sum = 0;
+        if(workers <= 1) {
+            sum = playSlice(a, b, 0, 1, seed);
+        } else {
+            int slices[MAX_WORKERS] = {0};
+            thread threads[MAX_WORKERS];
+            int started = 0;
+            try {
+                for(; started < workers; started++) {
+                    threads[started] = thread(&Tuner::playSliceInto, this, cref(a), cref(b), started, workers, seed,
+                                              &slices[started]);
+                }
+            } catch(const system_error&) {
+                for(int w = 0; w < started; w++) {
+                    threads[w].join();
+                }
+                throw runtime_error("Failed to start a tuner worker.");
+            }
+            for(int w = 0; w < workers; w++) {
+                threads[w].join();
+                sum += slices[w];
+            }
+        }
+        return sum;
+    }
+
+    // One SPSA iteration. Returns the score of the plus set against the minus set, in [-1, 1].
+    double step() {
+        double ak = config.a / pow(iteration + 1 + config.stabilityConstant, 0.602);
+        double ck = config.c / pow(iteration + 1, 0.101);
+        double theta[Params::MAX_PARAMS];
+        double delta[Params::MAX_PARAMS];
+        double plusTheta[Params::MAX_PARAMS];
+        double minusTheta[Params::MAX_PARAMS];
+        for(int i = 0; i < tunedCount; i++) {
+            theta[i] = normalised(i);
+            delta[i] = rand() % 2 == 0 ? 1 : -1;
+            plusTheta[i] = theta[i] + ck * delta[i];
+            minusTheta[i] = theta[i] - ck * delta[i];
+        }
+        ParamSet plus = current;
+        ParamSet minus = current;
+        Param view[Params::MAX_PARAMS];
+        Params::list(plus, view);
+        denormalise(plusTheta, view);
+        Params::list(minus, view);
+        denormalise(minusTheta, view);
+        double y = (double) playGames(plus, minus, config.seed + iteration * config.games) / config.games;
+        for(int i = 0; i < tunedCount; i++) {
+            theta[i] += ak * y / (2 * ck * delta[i]);
+        }
+        denormalise(theta, params);
+        iteration++;
+        return y;
+    }
+
+    void run(int iterations, ostream& log) {
+        for(int i = 0; i < iterations; i++) {
+            // The perturbations are drawn from a seed of their own, whatever the games drew before.
+            srand(config.seed * 7919 + iteration);
+            double y = step();
+            log << "Iteration " << iteration << "  plus vs minus: " << y << endl;
+        }
+    }
+};
+
+#endif //HYPERSONIC_TUNER_H
@@ -0,0 +1,159 @@
+#ifndef HYPERSONIC_TURNCONTEXT_H
+#define HYPERSONIC_TURNCONTEXT_H
+
+#include <bitset>
+#include <cstdint>
+
+#include "Board.h"
+
+using namespace std;
+
+/* Facts about the observed board which hold for the whole turn, so the searches don't rework them at every leaf.
+ * Built once a turn, after InputParser::update, and read by const reference.
+ * Regions are the connected components of the tiles a player can stand on: free tiles, and the tiles players are
+ * on (they may be standing on their bomb). A doomed box is one an explosion is already scheduled for; the rest
+ * are targets. Doomed boxes stay doomed for the rest of the turn's searches, as explosions are only ever brought
+ * forward.
+ **/
+class TurnContext {
+public:
+    static const int NO_REGION = -1;
+
+private:
+    bitset<Board::TILE_COUNT> doomed;
+    bitset<Board::TILE_COUNT> targets;
+    int boxes = 0;
+    int bombTimer = Bomb::TIMEOUT;
+    short regions[Board::TILE_COUNT];
+    short sizes[Board::TILE_COUNT];
+    int regionTotal = 0;
+    // Standable neighbours of each tile.
+    uint8_t escapeCounts[Board::TILE_COUNT];
+    int alive[Board::MAX_PLAYERS];
+    int playerCount = 0;
+
+    static bool standable(const Board& b, int tile) {
+        if(b.isFree(tile)) return true;
+        for(int p = 0; p < b.playerCount; p++) {
+            if(b.players[p].isAlive() && b.players[p].tile == tile) return true;
+        }
+        return false;
+    }
+
+    static bool scheduled(const Board& b, int tile) {
+        for(int k = 0; k < Bomb::TIMEOUT; k++) {
+            if(b.explodes(k)[tile]) return true;
+        }
+        return false;
+    }
+
+public:
+    void build(const Board& b) {
+        doomed.reset();
+        targets.reset();
+        boxes = 0;
+        bitset<Board::TILE_COUNT> stand;
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            if(b.isBox(t)) {
+                boxes++;
+                if(scheduled(b, t)) {
+                    doomed.set(t);
+                } else {
+                    targets.set(t);
+                }
+            }
+            if(standable(b, t)) stand.set(t);
+        }
+        bombTimer = Bomb::TIMEOUT;
+        for(int i = 0; i < b.bombCount; i++) {
+            int timer = b.bombs[i].explodeTurn - b.turn;
+            if(timer < bombTimer) bombTimer = timer;
+        }
+        for(int t = 0; t < Board::TILE_COUNT; t++) {
+            int count = 0;
+            for(int j = 0; j < Board::grid.neighbourCount[t]; j++) {
+                if(stand[Board::grid.neighbours[t][j]]) count++;
+            }
+            escapeCounts[t] = (uint8_t) count;
+            regions[t] = NO_REGION;
+        }
+        // Flood fill each region, breadth first.
+        regionTotal = 0;
+        int queue[Board::TILE_COUNT];
+        for(int start = 0; start < Board::TILE_COUNT; start++) {
+            if(!stand[start] || regions[start] != NO_REGION) continue;
+            int qIn = 0;
+            int qOut = 0;
+            regions[start] = (short) regionTotal;
+            queue[qIn++] = start;
+            while(qOut < qIn) {
+                int t = queue[qOut++];
+                for(int j = 0; j < Board::grid.neighbourCount[t]; j++) {
+                    int n = Board::grid.neighbours[t][j];
+                    if(!stand[n] || regions[n] != NO_REGION) continue;
+                    regions[n] = (short) regionTotal;
+                    queue[qIn++] = n;
+                }
+            }
+            sizes[regionTotal++] = (short) qIn;
+        }
+        playerCount = b.playerCount;
+        for(int p = 0; p < playerCount; p++) {
+            alive[p] = b.players[p].isAlive() ? b.players[p].tile : Board::INVALID_TILE;
+        }
+    }
+
+    // An explosion is scheduled for the box at tile.
+    bool isDoomed(int tile) const {
+        return doomed[tile];
+    }
+
+    // A box which nothing is going to destroy yet.
+    bool isTarget(int tile) const {
+        return targets[tile];
+    }
+
+    int boxCount() const {
+        return boxes;
+    }
+
+    int targetCount() const {
+        return (int) targets.count();
+    }
+
+    // Turns until the next bomb explodes; Bomb::TIMEOUT if there are no bombs.
+    int minBombTimer() const {
+        return bombTimer;
+    }
+
+    int regionCount() const {
+        return regionTotal;
+    }
+
+    // NO_REGION for tiles nobody can stand on.
+    int region(int tile) const {
+        return regions[tile];
+    }
+
+    // Tiles in the region of tile, 0 for tiles nobody can stand on.
+    int regionSize(int tile) const {
+        return regions[tile] == NO_REGION ? 0 : sizes[regions[tile]];
+    }
+
+    int escapes(int tile) const {
+        return escapeCounts[tile];
+    }
+
+    // Whether another live player shares a region with player.
+    bool enemyConnected(int player) const {
+        if(alive[player] == Board::INVALID_TILE) return false;
+        int r = regions[alive[player]];
+        for(int p = 0; p < playerCount; p++) {
+            if(p == player || alive[p] == Board::INVALID_TILE) continue;
+            if(regions[alive[p]] == r) return true;
+        }
+        return false;
+    }
+};
+
+#endif //HYPERSONIC_TURNCONTEXT_H
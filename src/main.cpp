@@ -7,6 +7,16 @@
 #include "InputParser.h"
 #include "AnnealingBot.h"
 #include "Bot.h"
+#include "ParanoidBot.h"
+#include "OpponentModel.h"
+#include "Heatmap.h"
+#include "TurnContext.h"
+#include "MoveOrdering.h"
+#include "Ponder.h"
+#include "Opening.h"
+#include "EndgameBot.h"
+#include "RegionBot.h"
+#include "MemoryArena.h"
 #include <chrono>
 
 using namespace std;
@@ -20,10 +30,37 @@ int main() {
     Bot<4> bot4(ip.ourID);
     Bot<4> bot4Duel(ip.ourID);
     Bot<5> bot5(ip.ourID);
-    Bot<6> bot6(ip.ourID);
+    // Enemies with enough observed turns are simulated by the learned model instead of the placeBomb guess.
+    const int minObservations = 10;
+    OpponentModel model;
+    ModelBot modelBots[Board::MAX_PLAYERS];
+    SimBot* enemyAI[Board::MAX_PLAYERS];
+    Heatmap heat;
+    // The first turn builds the heatmap and plans the opening; later turns keep them up to date.
+    Opening opening(ip.ourID);
+    bool started = false;
+    TurnContext context;
+    Territory territory;
+    // Shared by the depth first searches, and kept from turn to turn.
+    MoveOrdering ordering;
+    // A deeper search of the board we expect next, run while we wait for it. On a hit it gets this long after the
+    // input to finish, leaving the rest of the turn for bot5 if it doesn't.
+    Ponder<6> ponder(ip.ourID);
+    const long ponderWait = 40;
+    // Its transposition table is large, so it is only allocated once.
+    EndgameBot endgame(ip.ourID);
+    RegionBot region(ip.ourID);
     while (1) {
         long long startTime = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        // The engines give back what they take from the arena as they return; anything left is last turn's.
+        MemoryArena::forThread().reset();
         ip.update(board);
+        // Before anything the pondering bot reads (the model, through enemyAI) changes.
+        // startTime includes the wait for the input, so the deadline counts from now. A pondered search stopped at
+        // the deadline isn't used; bot5 searches the board instead.
+        bool pondered = ponder.finish(board, Ponder<6>::getTimeMilli() + ponderWait);
+        cerr << "Ponder hits: " << ponder.hits << " (late " << ponder.late << ") misses: " << ponder.misses << endl;
+        model.observe(board);
 //        for(int i = 0; i < Board::HEIGHT; i++) {
 //            for(int j = 0; j < Board::WIDTH; j++) {
 //                cerr << board.explodeTurn[j + i * Board::WIDTH] << " ";
@@ -34,25 +71,45 @@ int main() {
 //        cerr << "Board: " << endl << board;
         int targetTile;
         string action = "MOVE ";
-        int boxCount = 0;
-        int minBombTimer = 8;
-        for(int i = 0; i < Board::TILE_COUNT; i++) {
-            if(board.isBox(i)) boxCount++;
+        // The paranoid search models the enemies itself, so it gets the board as observed.
+        Board observed = board;
+        context.build(observed);
+        territory.build(observed);
+        ordering.newTurn();
+        int boxCount = context.boxCount();
+        int minBombTimer = context.minBombTimer();
+        if(started) {
+            heat.sync(observed);
+        } else {
+            opening.prepare(observed, heat, context);
+            started = true;
         }
-        for(int i = 0; i < board.bombCount; i++) {
-            minBombTimer = min(minBombTimer, board.bombs[i].explodeTurn - board.turn);
+        if(opening.onPlan(observed)) {
+            opening.seed(ordering);
         }
-
+        bot4.setHeatmap(&heat);
+        bot5.setHeatmap(&heat);
+        bot4.setContext(&context);
+        bot5.setContext(&context);
+        bot4.setOrdering(&ordering);
+        bot5.setOrdering(&ordering);
+        bot4.setTerritory(&territory);
+        bot5.setTerritory(&territory);
         // Our model of the enemies
+        int modelledCount = 0;
         for(int i = 0; i < board.playerCount; i++) {
-            if(i != board.US && board.players[i].isAlive() && board.players[i].bombsAvailable) {
+            if(i == board.US || !board.players[i].isAlive()) continue;
+            if(model.observations(i) >= minObservations) {
+                modelBots[i] = ModelBot(&model, i);
+                enemyAI[modelledCount++] = &modelBots[i];
+            } else if(board.players[i].bombsAvailable) {
                 board.placeBomb(i);
             }
         }
+        bot4.setEnemyAI(enemyAI, modelledCount);
+        bot5.setEnemyAI(enemyAI, modelledCount);
 
-        pair<int, int> cePair = BoardStats::closestPlayer(board, board.US);
-        bool disconnected = cePair.second == -1 && boxCount > 25;
-        bool enemyClose =  cePair.second < 8;
+        bool disconnected = !context.enemyConnected(board.US) && boxCount > 25;
         pair<int, bool> toMove;
         cerr << "Score pos: " << BoardStats::scorePos(board, board.US);
         int pos = 0;
@@ -66,23 +123,32 @@ int main() {
             cerr << "End game." << endl;
             pair<int, int> closestP = BoardStats::closestPlayer(board, board.US);
             cerr << "Closest: " << " (" << closestP.first << ", " << closestP.second << ")" << endl;
-            Bot<3> bot3(ip.ourID);
-            if(pos < board.aliveCount - 1) {
-                cerr << "Flee " << endl;
-                bot3.flee = true;
-                bot3.fleeFrom = board.players[closestP.first].tile;
+            bool flee = pos < board.aliveCount - 1;
+            if(boxCount == 0) {
+                // Only survival is left to play for, and the board is small enough to search deep.
+                endgame.fight = !flee;
+                toMove = endgame.move(observed);
             } else {
-                bot3.fight = true;
+                ParanoidBot<3> bot3(ip.ourID);
+                bot3.ordering = &ordering;
+                if(flee) {
+                    cerr << "Flee " << endl;
+                    bot3.flee = true;
+                    bot3.fleeFrom = board.players[closestP.first].tile;
+                } else {
+                    bot3.fight = true;
+                }
+                toMove = bot3.move(observed);
             }
-            toMove = bot3.move(board);
         } else {
             if (disconnected && !(board.bombCount > 3 && minBombTimer == 1)) {
-                bot6.distEnabled = false;
+                // No enemy can reach us, so only our own region matters.
                 cerr << "Disconnected" << endl;
-                toMove = bot6.move(board);
+                toMove = region.move(observed);
             } else {
                 if (false) {
                     cerr << "Modelling" << endl;
+                    pair<int, int> cePair = BoardStats::closestPlayer(board, board.US);
                     Bot<3> enemyBot(cePair.first);
                     enemyBot.distEnabled = false;
                     enemyBot.move(board);
@@ -96,14 +162,20 @@ int main() {
                         bot4.distEnabled = true;
                         toMove = bot4.move(board);
                     } else {
-                        cerr << "Normal (5 dist)." << endl;
-                        bot5.distEnabled = true;
-                        toMove = bot5.move(board);
+                        if(pondered) {
+                            cerr << "Normal, pondered (6 dist)." << endl;
+                            toMove = ponder.move();
+                        } else {
+                            cerr << "Normal (5 dist)." << endl;
+                            bot5.distEnabled = true;
+                            toMove = bot5.move(board);
+                        }
                     }
                 }
             }
         }
 
+        opening.played(observed, toMove);
         targetTile = board.adjTile(board.players[board.US].tile, toMove.first);
         if(toMove.second) {
                 action = "BOMB ";
@@ -112,6 +184,30 @@ int main() {
         cout << action << " " << target.x << " " << target.y << endl;
         long long endTime = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
         cerr << "Runtime: " << endTime-startTime << endl;
+
+        // The board we expect next: everyone steps, then we play toMove and the modelled enemies their predicted
+        // moves (the rest stand still). The search gets main's bomb guesses on top, as the bots do.
+        Board expected = observed;
+        expected.stepForward(1);
+        const Board stepped = expected;
+        for(int i = 0; i < expected.playerCount; i++) {
+            if(!stepped.players[i].isAlive()) continue;
+            Move m(Position::NONE, false);
+            if(i == board.US) {
+                m = Move(toMove.first, toMove.second);
+            } else if(model.observations(i) >= minObservations) {
+                m = model.predict(stepped, i);
+            }
+            if(m.bomb && SafeMoves::canBomb(expected, i)) expected.placeBomb(i);
+            if(expected.canMove(i, m.dir)) expected.move(i, m.dir);
+        }
+        Board search = expected;
+        for(int i = 0; i < search.playerCount; i++) {
+            if(i == board.US || !search.players[i].isAlive() || model.observations(i) >= minObservations) continue;
+            if(search.players[i].bombsAvailable) search.placeBomb(i);
+        }
+        ponder.engine().setEnemyAI(enemyAI, modelledCount);
+        ponder.start(expected, search, heat);
     }
 }
 
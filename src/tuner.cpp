@@ -0,0 +1,71 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "Params.h"
+#include "TunedParams.h"
+#include "Tuner.h"
+
+using namespace std;
+
+// Offline self-play tuner. Writes the tuned parameters as a params file, and optionally as TunedParams.h, which
+// is compiled into the bot.
+//   tuner [--engine bot|annealing] [--iterations N] [--games N] [--workers N] [--turns N] [--time MS]
+//         [--seed N] [--init params.txt] [--out params.txt] [--header src/TunedParams.h]
+int main(int argc, char* argv[]) {
+    TunerConfig config;
+    config.workers = max(1u, thread::hardware_concurrency());
+    int iterations = 100;
+    const char* init = NULL;
+    const char* out = "params.txt";
+    const char* header = NULL;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        const char* flag = argv[i];
+        const char* value = argv[i + 1];
+        if(strcmp(flag, "--engine") == 0) {
+            config.engine = strcmp(value, "annealing") == 0 ? TunerConfig::ANNEALING : TunerConfig::EXHAUSTIVE;
+        } else if(strcmp(flag, "--iterations") == 0) {
+            iterations = atoi(value);
+        } else if(strcmp(flag, "--games") == 0) {
+            config.games = atoi(value);
+        } else if(strcmp(flag, "--workers") == 0) {
+            config.workers = atoi(value);
+        } else if(strcmp(flag, "--turns") == 0) {
+            config.maxTurns = atoi(value);
+        } else if(strcmp(flag, "--time") == 0) {
+            config.annealingTimeMilli = atol(value);
+        } else if(strcmp(flag, "--seed") == 0) {
+            config.seed = (unsigned int) atol(value);
+        } else if(strcmp(flag, "--init") == 0) {
+            init = value;
+        } else if(strcmp(flag, "--out") == 0) {
+            out = value;
+        } else if(strcmp(flag, "--header") == 0) {
+            header = value;
+        } else {
+            cerr << "Unknown option: " << flag << endl;
+            return 1;
+        }
+    }
+    ParamSet start = defaultParamSet();
+    if(init != NULL) {
+        ifstream in(init);
+        if(!in || !Params::load(in, start)) {
+            cerr << "Couldn't load " << init << endl;
+            return 1;
+        }
+    }
+    Tuner tuner(config, start);
+    cout << "Tuning " << tuner.tunedParams() << " parameters with " << config.workers << " workers." << endl;
+    tuner.run(iterations, cout);
+    ofstream paramsOut(out);
+    Params::save(paramsOut, tuner.current);
+    if(header != NULL) {
+        ofstream headerOut(header);
+        Params::writeHeader(headerOut, tuner.current);
+    }
+    Params::save(cout, tuner.current);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "BeamBot.h"
+#include "InputParser.h"
+#include "Board.h"
+
+TEST(BeamBotTest, move) {
+    std::string input =
+        "13 11 0\n"
+        "...0.0.0.0...\n"
+        "1X.01X1X1X.X.\n"
+        ".X...2.2..121\n"
+        ".X.X2X1X2X1X.\n"
+        "....0.0.0.2.2\n"
+        ".X.X0X.X0X.X.\n"
+        "2.2.0.0.0.2.2\n"
+        ".X1X2X1X2X1X.\n"
+        "121..2.2..121\n"
+        ".X.X1X1X1X.X.\n"
+        "...0.0.0.0...\n"
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    BeamBot bot(0);
+    pair<int, bool> move = bot.move(b);
+    // Without a time limit the beam runs to full depth.
+    EXPECT_EQ(BeamBot::MAX_PLIES, bot.depthReached);
+    EXPECT_EQ(BeamBot::MAX_PLIES, bot.planLength);
+    EXPECT_EQ(move.first, bot.plan[0].dir);
+    EXPECT_EQ(move.second, bot.plan[0].bomb);
+    // The plan should farm boxes from the start.
+    int bombs = 0;
+    for(int i = 0; i < bot.planLength; i++) {
+        if(bot.plan[i].bomb) bombs++;
+    }
+    EXPECT_GE(bombs, 2);
+}
+
+TEST(BeamBotTest, suicidePrevention) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        "2............\n" // 4
+        ".X.X.........\n" // 5
+        ".1.1.........\n" // 6
+        ".X.X.........\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    // Player trapped, should wait for box to open and escape.
+    b.players[0].tile = Board::toID(6, 0);
+    int blastLength = 3;
+    int timer = 7;
+    b.placeBombOnly(0, Board::toID(8, 0), timer, blastLength);
+    timer = 5;
+    b.placeBombOnly(0, Board::toID(6, 2), timer, blastLength);
+    BeamBot bot(0);
+    pair<int, bool> move = bot.move(b);
+    EXPECT_FALSE(move.second);
+    // Narrow beams should still see the danger.
+    bot.setBeamWidth(10);
+    EXPECT_EQ(10, bot.beamWidth());
+    move = bot.move(b);
+    EXPECT_FALSE(move.second);
+}
+
+TEST(BeamBotTest, timeLimit) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    // A zero allocation still completes the first ply.
+    BeamBot bot(0, 0, 5000);
+    bot.move(b);
+    EXPECT_EQ(1, bot.depthReached);
+}
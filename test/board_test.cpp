@@ -390,3 +390,166 @@ TEST(BoardTest, stepForwardItemShield) {
 
 
 
+
+TEST(BoardTest, gridTables) {
+    // Corner, edge and middle tiles.
+    EXPECT_EQ(2, Board::grid.neighbourCount[0]);
+    EXPECT_EQ(3, Board::grid.neighbourCount[Board::toID(0, 5)]);
+    EXPECT_EQ(4, Board::grid.neighbourCount[Board::toID(5, 5)]);
+    EXPECT_EQ(Board::toID(5, 4), Board::grid.neighbours[Board::toID(5, 5)][0]);
+    EXPECT_EQ(Board::toID(6, 5), Board::grid.neighbours[Board::toID(5, 5)][3]);
+    EXPECT_EQ(22, Board::dist(0, Board::TILE_COUNT - 1));
+    EXPECT_EQ(Board::dist(Board::toPosition(17), Board::toPosition(96)), Board::dist(17, 96));
+}
+
+TEST(BoardTest, pathCacheLayoutChange) {
+    std::string input =
+        "13 11 0\n"
+        ".0...........\n"
+        "0X...........\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        "1\n"
+        "0 0 0 0 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    int target = Board::toID(2, 2);
+    EXPECT_EQ(-1, b.pathDist(0, target));
+    // Destroying a box changes the layout, so the cached distances are dropped.
+    b.tiles[1] = Board::EMPTY;
+    EXPECT_EQ(4, b.pathDist(0, target));
+    EXPECT_EQ(0, b.pathDist(target, target));
+}
+
+TEST(BoardTest, sweep) {
+    // Every tile kind, in an order which puts destroyed boxes in the vector body and the scalar tail.
+    const char kinds[] = {'.', '0', '1', '2', '3', '4', '5', 'r', 'c', 'X', 'B'};
+    char tiles[Board::TILE_COUNT];
+    bool row[Board::TILE_COUNT];
+    for(int i = 0; i < Board::TILE_COUNT; i++) {
+        tiles[i] = kinds[(i * 7) % sizeof(kinds)];
+        row[i] = i % 5 == 0 || i == Board::TILE_COUNT - 1;
+    }
+    char expected[Board::TILE_COUNT];
+    for(int i = 0; i < Board::TILE_COUNT; i++) {
+        expected[i] = Sweep::settled(tiles[i]);
+    }
+    Sweep::settleDestroyed(tiles, Board::TILE_COUNT);
+    EXPECT_EQ(0, memcmp(expected, tiles, sizeof(tiles)));
+    EXPECT_EQ(Board::EMPTY, Sweep::settled(Board::BOX_DESTROYED));
+    EXPECT_EQ(Board::BOMB_RANGE_PU, Sweep::settled(Board::BOMB_RANGE_BOX_DESTROYED));
+    EXPECT_EQ(Board::BOMB_COUNT_PU, Sweep::settled(Board::BOMB_COUNT_BOX_DESTROYED));
+
+    int indices[Board::TILE_COUNT];
+    int count = Sweep::setIndices(row, Board::TILE_COUNT, indices);
+    ASSERT_EQ(30, count);
+    for(int i = 0; i < count - 1; i++) {
+        EXPECT_EQ(i * 5, indices[i]);
+    }
+    EXPECT_EQ(Board::TILE_COUNT - 1, indices[count - 1]);
+}
+
+// Every bomb is in the bucket of its explode turn, and nothing else is.
+static void expectBombSlots(const Board& b) {
+    int bits = 0;
+    for(int s = 0; s < Bomb::TIMEOUT; s++) {
+        bits += __builtin_popcount(b.bombSlots[s]);
+    }
+    ASSERT_EQ(b.bombCount, bits);
+    for(int i = 0; i < b.bombCount; i++) {
+        EXPECT_TRUE(b.bombSlots[Board::bombSlot(b.bombs[i])] & (1u << i));
+    }
+}
+
+TEST(BoardTest, bombSlots) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        "...........0.\n"
+        "2\n"
+        "0 0 0 0 3 3\n"
+        "0 1 12 10 1 3\n";
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    b.placeBomb(0);
+    b.stepForward(1);
+    b.players[0].tile = Board::toID(0, 4);
+    b.placeBomb(0);
+    b.stepForward(1);
+    // In range of the first bomb, and the second in range of it, so all three explode together.
+    b.players[0].tile = Board::toID(0, 2);
+    b.placeBomb(0);
+    b.players[1].tile = Board::toID(10, 12);
+    b.placeBomb(1);
+    expectBombSlots(b);
+    ASSERT_EQ(4, b.bombCount);
+    EXPECT_EQ(0, b.players[0].bombsAvailable);
+
+    b.stepForward(Bomb::TIMEOUT - 3);
+    EXPECT_EQ(4, b.bombCount);
+    b.stepForward(1);
+    expectBombSlots(b);
+    EXPECT_EQ(1, b.bombCount);
+    EXPECT_EQ(3, b.players[0].bombsAvailable);
+    EXPECT_EQ(0, b.players[1].bombsAvailable);
+    b.stepForward(2);
+    expectBombSlots(b);
+    EXPECT_EQ(0, b.bombCount);
+    EXPECT_EQ(1, b.players[1].bombsAvailable);
+}
+
+// Ranges past the width of the board, from the input or from picked up items, blast the whole row instead of
+// wrapping around in Bomb::blastLength.
+TEST(BoardTest, longBlastClamped) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        "1 1 12 8 8 20\n";
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    ASSERT_EQ(1, b.bombCount);
+    EXPECT_EQ(Board::WIDTH - 1, b.bombs[0].blastLength);
+    EXPECT_TRUE(b.explodes(7)[Board::toID(8, 0)]);
+
+    b.players[0].range = 17;
+    b.placeBomb(0);
+    ASSERT_EQ(2, b.bombCount);
+    EXPECT_EQ(Board::WIDTH - 1, b.bombs[1].blastLength);
+    EXPECT_TRUE(b.explodes(Bomb::TIMEOUT - 1)[Board::toID(0, 12)]);
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "Bot.h"
+#include "Match.h"
 #include "Board.h"
 #include "InputParser.h"
 
@@ -854,7 +855,42 @@ TEST(BotTest, ab) {
     Board b = ip.parse();
 }
 
+// Branch and bound, and move ordering, give the same move and score as the full search.
+TEST(BotTest, pruneExact) {
+    long long fullLeaves = 0;
+    long long prunedLeaves = 0;
+    for(unsigned int seed = 1; seed <= 4; seed++) {
+        Board b = Match::randomBoard(seed);
+        // Some play, so there are bombs about.
+        for(int t = 0; t < 6; t++) {
+            b.stepForward(1);
+            for(int p = 0; p < 2; p++) {
+                if(b.players[p].bombsAvailable > 0 && t % 3 == p) b.placeBomb(p);
+                int dir = (seed + t) % 2 == 0 ? Position::RIGHT : Position::DOWN;
+                if(p == 1) dir = (dir + 2) % 4;
+                if(b.canMove(p, dir)) b.move(p, dir);
+            }
+        }
+        Heatmap heat;
+        heat.build(b);
+        Bot<5> full(0);
+        full.prune = false;
+        full.orderMoves = false;
+        full.setHeatmap(&heat);
+        Bot<5> pruned(0);
+        pruned.setHeatmap(&heat);
+        pair<int, bool> fullMove = full.move(b);
+        pair<int, bool> prunedMove = pruned.move(b);
+        EXPECT_EQ(fullMove, prunedMove) << seed;
+        EXPECT_DOUBLE_EQ(full.bestScore, pruned.bestScore) << seed;
+        EXPECT_LE(pruned.nodeCount, full.nodeCount);
+        fullLeaves += full.leafCount;
+        prunedLeaves += pruned.leafCount;
+    }
+    EXPECT_LT(prunedLeaves, fullLeaves);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "EndgameBot.h"
+#include "test_boards.h"
+#include "Board.h"
+
+static const std::string OPEN_ROWS =
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n";
+
+// Player 0 is in a corner next to a bomb which explodes next step, so it has to leave the row. The same board
+// upside down has the same value, and the move upside down.
+TEST(EndgameBotTest, escapeAndReflection) {
+    Board top = parse("13 11 0\n" ".............\n" + OPEN_ROWS + ".............\n"
+                      "3\n" "0 0 0 0 1 3\n" "0 1 12 10 1 3\n" "1 1 1 0 2 3\n");
+    Board bottom = parse("13 11 0\n" ".............\n" + OPEN_ROWS + ".............\n"
+                         "3\n" "0 0 0 10 1 3\n" "0 1 12 0 1 3\n" "1 1 1 10 2 3\n");
+    EndgameBot topBot(0, EndgameBot::UNSET);
+    topBot.maxDepth = 4;
+    EndgameBot bottomBot(0, EndgameBot::UNSET);
+    bottomBot.maxDepth = 4;
+    pair<int, bool> down = topBot.move(top);
+    pair<int, bool> up = bottomBot.move(bottom);
+    EXPECT_EQ(Position::DOWN, down.first);
+    EXPECT_EQ(Position::UP, up.first);
+    EXPECT_EQ(down.second, up.second);
+    EXPECT_DOUBLE_EQ(topBot.bestScore, bottomBot.bestScore);
+    EXPECT_EQ(4, topBot.depthReached);
+    EXPECT_GT(topBot.tableHits, 0);
+}
+
+// The enemy is in a dead end along the top row, and we stand in its only way out. Bombing it in still leaves us
+// time to get round the corner, so the kill is forced and the search stops once it finds it.
+TEST(EndgameBotTest, trapKills) {
+    Board b = parse("13 11 0\n"
+                    ".............\n"
+                    "XXXXX.X.X.X.X\n"
+                    ".............\n"
+                    ".X.X.X.X.X.X.\n"
+                    ".............\n"
+                    ".X.X.X.X.X.X.\n"
+                    ".............\n"
+                    ".X.X.X.X.X.X.\n"
+                    ".............\n"
+                    ".X.X.X.X.X.X.\n"
+                    ".............\n"
+                    "2\n"
+                    "0 0 3 0 1 3\n"
+                    "0 1 0 0 1 2\n");
+    EndgameBot bot(0, EndgameBot::UNSET);
+    bot.maxDepth = 10;
+    bot.move(b);
+    EXPECT_GE(bot.bestScore, EndgameBot::KILL_SCORE / 10);
+    EXPECT_LT(bot.depthReached, 10);
+}
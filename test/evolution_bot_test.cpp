@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+
+#include "EvolutionBot.h"
+#include "InputParser.h"
+#include "Board.h"
+
+TEST(EvolutionBotTest, avoidUnsafeItem) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        "XXX.X........\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    b.players[0].tile = Board::toID(0, 3);
+    // Powerup acts as shield, behind it, but not when picked up.
+    b.tiles[Board::toID(0, 4)] = Board::BOMB_COUNT_PU;
+    int bombTimer = 3;
+    int range = 10;
+    b.placeBombOnly(0, Board::toID(0, 2), bombTimer, range);
+
+    srand(0);
+    typedef EvolutionBot<6, 2> EB;
+    EB eb(0);
+    MinimalBot enemyAI(1);
+    SimBot* allEnemyAI[] {&enemyAI};
+    eb.setEnemyAI(allEnemyAI);
+    Move move = eb.move(b);
+    EXPECT_EQ(EB::DEFAULT_GENERATIONS, eb.generations);
+    EXPECT_EQ(Position::DOWN, move.dir);
+    EXPECT_FALSE(move.bomb);
+}
+
+TEST(EvolutionBotTest, shift) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    srand(0);
+    EvolutionBot<6, 2, 4> eb(0);
+    MinimalBot enemyAI(1);
+    SimBot* allEnemyAI[] {&enemyAI};
+    eb.setEnemyAI(allEnemyAI);
+    eb.move(b);
+    Move before[6];
+    memcpy(before, eb.plan(1), sizeof(before));
+    // The next turn continues from the current population, one move on.
+    eb.shift();
+    for(int i = 0; i < 5; i++) {
+        EXPECT_EQ(before[i + 1].dir, eb.plan(1)[i].dir);
+        EXPECT_EQ(before[i + 1].bomb, eb.plan(1)[i].bomb);
+    }
+}
+
+// Player 0 is in the corner, next to a bomb which explodes this step: only stepping down survives. The plan's bomb
+// in place is repaired to it, in the plan too.
+TEST(EvolutionBotTest, repairCertainDeath) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        "1 1 1 0 2 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    b.stepForward(1);
+    Move plan[] {Move(Position::NONE, true)};
+    RepairingAI ai(0, plan, 0);
+    Move move = ai.move(b);
+    EXPECT_EQ(Position::DOWN, move.dir);
+    EXPECT_FALSE(move.bomb);
+    EXPECT_EQ(Position::DOWN, plan[0].dir);
+    EXPECT_FALSE(plan[0].bomb);
+}
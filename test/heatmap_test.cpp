@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include "Heatmap.h"
+#include "Mechanics.h"
+#include "InputParser.h"
+#include "Board.h"
+
+class HeatmapTest : public ::testing::Test {
+protected:
+    Board b;
+
+    void SetUp() {
+        std::string input =
+            "13 11 0\n"
+            "...0.0.0.0...\n"
+            "1X.01X1X1X.X.\n"
+            "121..2.2..121\n"
+            ".X1X2X1X2X1X.\n"
+            "2.2.0.0.0.2.2\n"
+            ".X.X0X.X0X.X.\n"
+            "2.2.0.0.0.2.2\n"
+            ".X1X2X1X2X1X.\n"
+            "121..2.2..121\n"
+            ".X.X1X1X1X.X.\n"
+            "...0.0.0.0...\n"
+            "2\n"
+            "0 0 0 0 1 3\n"
+            "0 1 12 10 1 3\n";
+        std::istringstream stream(input);
+        InputParser ip(stream);
+        ip.init();
+        b = ip.parse();
+    }
+
+    // Every value should match a blast count on the settled board.
+    void expectMatchesBlastCounts(const Heatmap& heat, const Board& board) {
+        Board snapshot = Mechanics::settled(board);
+        for(int range = 1; range <= 4; range++) {
+            for(int t = 0; t < Board::TILE_COUNT; t++) {
+                if(board.tiles[t] == Board::WALL) continue;
+                ASSERT_EQ(Mechanics::blastCountAt(snapshot, t, range), heat.value(range, t))
+                        << "range " << range << " at " << Board::toPosition(t);
+            }
+        }
+    }
+};
+
+TEST_F(HeatmapTest, build) {
+    Heatmap heat;
+    heat.build(b);
+    expectMatchesBlastCounts(heat, b);
+    EXPECT_EQ(2, heat.value(1, Board::toID(2, 0)));
+    EXPECT_EQ(heat.value(Heatmap::MAX_RANGE, 0), heat.value(100, 0));
+}
+
+TEST_F(HeatmapTest, incrementalSync) {
+    Heatmap heat;
+    heat.build(b);
+    // Bombs schedule some boxes. The blasts should now see through them.
+    b.players[0].tile = Board::toID(2, 4);
+    b.placeBomb(0);
+    b.placeBombOnly(1, Board::toID(6, 6), Bomb::TIMEOUT, 3);
+    heat.sync(b);
+    EXPECT_FALSE(heat.isTarget(Board::toID(2, 5)));
+    expectMatchesBlastCounts(heat, b);
+    // And once they have gone off.
+    b.stepForward(Bomb::TIMEOUT);
+    heat.sync(b);
+    expectMatchesBlastCounts(heat, b);
+}
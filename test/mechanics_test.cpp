@@ -162,6 +162,44 @@ TEST(MechanicsTest, maximizeBlastWithBombs) {
 }
 
 
+TEST(MechanicsTest, bombSpots) {
+    std::string input =
+        "13 11 0\n"
+        "....0.0.0.0..\n"
+        ".............\n"
+        ".....0.0.....\n"
+        "0.0.0...0.0.0\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        ".............\n"
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    Board before = b;
+    BombSpot spots[Board::TILE_COUNT];
+    int count = Mechanics::bombSpots(b, b.ourTile(), 3, 3, spots);
+    // Tiles 0, 1 and 2 steps away.
+    ASSERT_EQ(6, count);
+    EXPECT_EQ(b.ourTile(), spots[0].tile);
+    EXPECT_EQ(0, spots[0].steps);
+    EXPECT_EQ(2, spots[count - 1].steps);
+    for(int i = 0; i < count; i++) {
+        EXPECT_EQ(Mechanics::blastCount(b, Board::toPosition(spots[i].tile), 3), spots[i].boxes);
+    }
+    // The board is only read.
+    EXPECT_EQ(0, memcmp(before.tiles, b.tiles, sizeof(b.tiles)));
+    EXPECT_EQ(before.turn, b.turn);
+}
+
 TEST(MechanicsTest, closestCount) {
     std::string input =
         "13 11 0\n"
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include "MemoryArena.h"
+#include "Board.h"
+#include "Simulation.h"
+#include "BeamBot.h"
+#include "ParanoidBot.h"
+#include "EndgameBot.h"
+#include "Match.h"
+
+TEST(MemoryArenaTest, allocateAndReset) {
+    MemoryArena arena(4 * sizeof(Board));
+    Board* boards = arena.make<Board>(3);
+    ASSERT_TRUE(boards != NULL);
+    EXPECT_EQ(0, (uintptr_t) boards % alignof(Board));
+    EXPECT_EQ(0, boards[2].bombCount);
+    // No room for two more.
+    EXPECT_TRUE(arena.make<Board>(2) == NULL);
+
+    size_t m = arena.mark();
+    Move* moves = arena.make<Move>(8);
+    ASSERT_TRUE(moves != NULL);
+    arena.rewind(m);
+    EXPECT_EQ(m, arena.bytesUsed());
+
+    arena.reset();
+    EXPECT_EQ(0u, arena.bytesUsed());
+    EXPECT_TRUE(arena.make<Board>(4) != NULL);
+    EXPECT_EQ(4 * sizeof(Board), arena.peakBytes());
+}
+
+TEST(MemoryArenaTest, pool) {
+    MemoryArena arena(1 << 16);
+    ArenaPool<Move> moves(arena, 10);
+    ASSERT_EQ(10, moves.capacity());
+    Move* list = moves.take(8);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_TRUE(moves.take(3) == NULL);
+    EXPECT_TRUE(moves.take() != NULL);
+    EXPECT_TRUE(moves.take() != NULL);
+    EXPECT_TRUE(moves.full());
+    size_t used = arena.bytesUsed();
+    moves.reset();
+    EXPECT_EQ(0, moves.size());
+    EXPECT_EQ(list, moves.take(8));
+    // The pool's storage stays taken from the arena.
+    EXPECT_EQ(used, arena.bytesUsed());
+
+    ArenaPool<Board> tooBig(arena, 1000);
+    EXPECT_EQ(0, tooBig.capacity());
+    EXPECT_TRUE(tooBig.take() == NULL);
+}
+
+TEST(MemoryArenaTest, perThread) {
+    MemoryArena* main = &MemoryArena::forThread();
+    MemoryArena* other = NULL;
+    std::thread t([&other]() {
+        other = &MemoryArena::forThread();
+        other->make<Board>();
+    });
+    t.join();
+    EXPECT_NE(main, other);
+    EXPECT_EQ(main, &MemoryArena::forThread());
+}
+
+// The engines take their boards from the thread's arena, and give them back when the move returns.
+TEST(MemoryArenaTest, engines) {
+    MemoryArena& arena = MemoryArena::forThread();
+    arena.reset();
+    size_t m = arena.mark();
+    {
+        ArenaScope scope(arena);
+        arena.make<Move>(4);
+    }
+    EXPECT_EQ(m, arena.bytesUsed());
+
+    Board b = Match::randomBoard(3);
+    BeamBot beam(0, BeamBot::UNSET, 20);
+    beam.maxPlies = 3;
+    beam.move(b);
+    EXPECT_EQ(m, arena.bytesUsed());
+    EXPECT_GE(arena.peakBytes(), 2 * 20 * sizeof(Board));
+
+    ParanoidBot<2> paranoid(0);
+    paranoid.move(b);
+    EndgameBot endgame(0, EndgameBot::UNSET);
+    endgame.maxDepth = 2;
+    endgame.move(b);
+    EXPECT_EQ(m, arena.bytesUsed());
+}
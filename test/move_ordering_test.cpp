@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include "MoveOrdering.h"
+#include "Bot.h"
+#include "Match.h"
+
+TEST(MoveOrderingTest, order) {
+    MoveOrdering ordering;
+    const int tile = 20;
+    Move moves[4] = {Move(Position::RIGHT, false), Move(Position::DOWN, false), Move(Position::LEFT, true),
+                     Move(Position::NONE, false)};
+    // Nothing known: the order is kept.
+    ordering.order(0, tile, true, moves, 4);
+    EXPECT_EQ(Position::RIGHT, moves[0].dir);
+    EXPECT_EQ(Position::NONE, moves[3].dir);
+
+    // History, deeper counting for more.
+    ordering.good(3, tile, Move(Position::DOWN, false), 1);
+    ordering.good(3, tile, Move(Position::NONE, false), 3);
+    // A killer at ply 0.
+    ordering.good(0, 50, Move(Position::LEFT, true), 1);
+    Move pv[2] = {Move(Position::NONE, false), Move(Position::UP, false)};
+    ordering.setPV(pv, 2);
+    ordering.order(0, tile, true, moves, 4);
+    // The PV move is only first while the search follows the PV.
+    EXPECT_EQ(Position::NONE, moves[0].dir);
+    EXPECT_EQ(Position::LEFT, moves[1].dir);
+    EXPECT_TRUE(moves[1].bomb);
+    EXPECT_EQ(Position::DOWN, moves[2].dir);
+    EXPECT_EQ(Position::RIGHT, moves[3].dir);
+    ordering.order(0, tile, false, moves, 4);
+    EXPECT_EQ(Position::LEFT, moves[0].dir);
+    EXPECT_EQ(Position::NONE, moves[1].dir);
+}
+
+TEST(MoveOrderingTest, newTurn) {
+    MoveOrdering ordering;
+    Move pv[3] = {Move(Position::NONE, false), Move(Position::UP, true), Move(Position::LEFT, false)};
+    ordering.setPV(pv, 3);
+    ordering.good(1, 30, Move(Position::DOWN, true), 4);
+    const Move down(Position::DOWN, true);
+    EXPECT_EQ(16, ordering.priority(MoveOrdering::MAX_PLY, 30, down, false));
+
+    ordering.newTurn();
+    ASSERT_EQ(2, ordering.pvSize());
+    EXPECT_EQ(Position::UP, ordering.pvMove(0).dir);
+    EXPECT_TRUE(ordering.onPV(1, Move(Position::LEFT, false)));
+    // Last turn's ply 1 killer is this turn's ply 0 killer.
+    EXPECT_EQ((int) MoveOrdering::KILLER_PRIORITY, ordering.priority(0, 99, down, false));
+    EXPECT_EQ(8, ordering.priority(1, 30, down, false));
+}
+
+TEST(MoveOrderingTest, botExact) {
+    for(unsigned int seed = 1; seed <= 3; seed++) {
+        Board b = Match::randomBoard(seed);
+        Heatmap heat;
+        heat.build(b);
+        MoveOrdering ordering;
+        Bot<5> plain(0);
+        plain.setHeatmap(&heat);
+        Bot<5> ordered(0);
+        ordered.setHeatmap(&heat);
+        ordered.setOrdering(&ordering);
+        // Two turns, so the second starts from the first's tables.
+        for(int turn = 0; turn < 2; turn++) {
+            pair<int, bool> plainMove = plain.move(b);
+            pair<int, bool> orderedMove = ordered.move(b);
+            EXPECT_EQ(plainMove, orderedMove) << seed;
+            EXPECT_DOUBLE_EQ(plain.bestScore, ordered.bestScore) << seed;
+            ASSERT_GT(ordering.pvSize(), 0);
+            EXPECT_EQ(orderedMove.first, ordering.pvMove(0).dir);
+            EXPECT_EQ(orderedMove.second, ordering.pvMove(0).bomb);
+            if(orderedMove.second) b.placeBomb(0);
+            b.move(0, orderedMove.first);
+            b.stepForward(1);
+            ordering.newTurn();
+        }
+    }
+}
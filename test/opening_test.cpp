@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+
+#include "Opening.h"
+#include "Match.h"
+
+TEST(OpeningTest, followPlan) {
+    Board b = Match::randomBoard(3);
+    TurnContext context;
+    context.build(b);
+    Heatmap heat;
+    Opening opening(0, BeamBot::UNSET);
+    opening.prepare(b, heat, context);
+    // Without a time limit the plan is full length.
+    ASSERT_EQ((int) Opening::PLIES, opening.planLength);
+    Heatmap built;
+    built.build(b);
+    for(int t = 0; t < Board::TILE_COUNT; t++) {
+        EXPECT_EQ(built.value(3, t), heat.value(3, t)) << t;
+    }
+
+    // Keeping to the plan, with the enemy standing still.
+    MoveOrdering ordering;
+    for(int turn = 0; turn < 3; turn++) {
+        ASSERT_TRUE(opening.onPlan(b)) << turn;
+        opening.seed(ordering);
+        ASSERT_EQ((int) Opening::PLIES - turn, ordering.pvSize());
+        Move m = ordering.pvMove(0);
+        EXPECT_EQ(opening.plan[turn].dir, m.dir);
+        opening.played(b, pair<int, bool>(m.dir, m.bomb));
+        b.stepForward(1);
+        if(m.bomb) b.placeBomb(0);
+        b.move(0, m.dir);
+    }
+
+    // Any other move drops it.
+    ASSERT_TRUE(opening.onPlan(b));
+    Move next = opening.plan[3];
+    opening.played(b, pair<int, bool>(next.dir, !next.bomb));
+    EXPECT_FALSE(opening.onPlan(b));
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include "OpponentModel.h"
+#include "InputParser.h"
+#include "Board.h"
+#include "Bot.h"
+
+class OpponentModelTest: public ::testing::Test {
+protected:
+    // Two turns. The enemy, next to a box, bombs and steps left.
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        "............0\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        "............0\n" // 9
+        ".............\n" // 10
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 11 10 0 3\n"
+        "1 1 12 10 8 3\n";
+};
+
+TEST_F(OpponentModelTest, observe) {
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    OpponentModel model;
+    Board first = ip.parse();
+    model.observe(first);
+    int ctx = OpponentModel::context(first, 1);
+    Board second = ip.parse();
+    model.observe(second);
+    EXPECT_EQ(1, model.observations(1));
+    EXPECT_EQ(0, model.observations(0));
+    EXPECT_EQ(1, model.count(1, ctx, OpponentModel::BOMB_MOVE));
+    // Same context, same action.
+    EXPECT_EQ(OpponentModel::BOMB_MOVE, model.predictAction(first, 1));
+    Move m = model.predict(first, 1);
+    EXPECT_TRUE(m.bomb);
+    EXPECT_NE(Position::NONE, m.dir);
+    // Unseen context: no bomb to place. Defaults to standing still.
+    EXPECT_EQ(OpponentModel::STAY, model.predictAction(second, 1));
+}
+
+TEST_F(OpponentModelTest, modelBotInSearch) {
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    OpponentModel model;
+    Board first = ip.parse();
+    model.observe(first);
+    model.observe(ip.parse());
+    ModelBot enemy(&model, 1);
+    SimBot* enemies[] {&enemy};
+    Bot<3> bot(0);
+    bot.setEnemyAI(enemies, 1);
+    pair<int, bool> move = bot.move(first);
+    EXPECT_NE(Position::NONE, move.first);
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include "ParanoidBot.h"
+#include "InputParser.h"
+#include "Board.h"
+
+TEST(ParanoidBotTest, avoidDeadEndNextToEnemy) {
+    std::string input =
+        "13 11 0\n"
+        "XXX..........\n" // 0
+        "X.X..........\n" // 1
+        "X.X..........\n" // 2
+        "X.X..........\n" // 3
+        ".............\n" // 4
+        ".............\n" // 5
+        ".............\n" // 6
+        ".............\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 1 4 1 4\n"
+        "0 1 3 4 1 4\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    ParanoidBot<3> bot(0);
+    bot.fight = true;
+    pair<int, bool> move = bot.move(b);
+    // Going up into the alley lets the enemy seal us in with one bomb.
+    EXPECT_NE(Position::UP, move.first);
+    EXPECT_GT(bot.nodeCount, 0);
+}
+
+TEST(ParanoidBotTest, distantEnemyIgnored) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n" // 0
+        ".............\n" // 1
+        ".............\n" // 2
+        ".............\n" // 3
+        "2............\n" // 4
+        ".X.X.........\n" // 5
+        ".1.1.........\n" // 6
+        ".X.X.........\n" // 7
+        ".............\n" // 8
+        ".............\n" // 9
+        ".............\n" // 10
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    // Player trapped, should wait for box to open and escape.
+    b.players[0].tile = Board::toID(6, 0);
+    int blastLength = 3;
+    int timer = 7;
+    b.placeBombOnly(0, Board::toID(8, 0), timer, blastLength);
+    timer = 5;
+    b.placeBombOnly(0, Board::toID(6, 2), timer, blastLength);
+    ParanoidBot<3> bot(0);
+    pair<int, bool> move = bot.move(b);
+    EXPECT_FALSE(move.second);
+    // With no opponent in range, each node is one of our moves only.
+    EXPECT_LE(bot.nodeCount, 10 * 10 * 10);
+}
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include "Ponder.h"
+#include "Match.h"
+
+// The board after a step and these moves, the way Match advances it.
+static Board advance(const Board& b, Move ours, Move theirs) {
+    Board next = b;
+    next.stepForward(1);
+    Move moves[] = {ours, theirs};
+    for(int p = 0; p < 2; p++) {
+        if(moves[p].bomb && SafeMoves::canBomb(next, p)) next.placeBomb(p);
+        if(next.canMove(p, moves[p].dir)) next.move(p, moves[p].dir);
+    }
+    return next;
+}
+
+TEST(PonderTest, hitAndMiss) {
+    Board b = Match::randomBoard(2);
+    b = advance(b, Move(Position::NONE, true), Move(Position::NONE, true));
+    Heatmap heat;
+    heat.build(b);
+    Ponder<4> ponder(0);
+
+    Board expected = advance(b, Move(Position::RIGHT, false), Move(Position::NONE, false));
+    ponder.start(expected, expected, heat);
+    // Built separately, as the parsed board would be.
+    Board actual = advance(b, Move(Position::RIGHT, false), Move(Position::NONE, false));
+    // Without a time limit to speak of.
+    const long long never = Ponder<4>::getTimeMilli() + 600000;
+    ASSERT_TRUE(ponder.finish(actual, never));
+    EXPECT_EQ(1, ponder.hits);
+
+    Heatmap directHeat;
+    directHeat.build(actual);
+    TurnContext context;
+    context.build(actual);
+    Bot<4> direct(0);
+    direct.setHeatmap(&directHeat);
+    direct.setContext(&context);
+    EXPECT_EQ(direct.move(actual), ponder.move());
+
+    // The enemy did something else.
+    ponder.start(expected, expected, heat);
+    Board other = advance(b, Move(Position::RIGHT, false), Move(Position::LEFT, false));
+    EXPECT_FALSE(ponder.finish(other, never));
+    EXPECT_EQ(1, ponder.misses);
+    // Nothing is running, so there's nothing to finish.
+    EXPECT_FALSE(ponder.finish(actual, never));
+}
+
+TEST(PonderTest, stop) {
+    Board b = Match::randomBoard(4);
+    atomic<bool> stop(true);
+    Bot<5> bot(0);
+    bot.stop = &stop;
+    bot.move(b);
+    EXPECT_EQ(0, bot.nodeCount);
+
+    // Cancelling straight away joins the worker cleanly.
+    Heatmap heat;
+    heat.build(b);
+    Ponder<6> ponder(0);
+    ponder.start(b, b, heat);
+    ponder.cancel();
+    EXPECT_FALSE(ponder.finish(b, Ponder<6>::getTimeMilli()));
+}
+
+// A hit whose search hasn't finished by the deadline is stopped, and not to be used.
+TEST(PonderTest, deadline) {
+    Board b = Match::randomBoard(4);
+    Heatmap heat;
+    heat.build(b);
+    Ponder<6> ponder(0);
+    ponder.start(b, b, heat);
+    EXPECT_FALSE(ponder.finish(b, Ponder<6>::getTimeMilli() - 1));
+    EXPECT_EQ(1, ponder.hits);
+    EXPECT_EQ(1, ponder.late);
+    // The worker has been joined.
+    EXPECT_FALSE(ponder.finish(b, Ponder<6>::getTimeMilli()));
+}
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "RegionBot.h"
+#include "test_boards.h"
+#include "Board.h"
+
+// Player 0 is shut in the top left corner by boxes: five free tiles, three boxes on their border.
+static const std::string POCKET =
+        "13 11 0\n"
+        "...0.........\n"
+        ".X.X.X.X.X.X.\n"
+        "000..........\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n";
+
+TEST(RegionBotTest, extract) {
+    Board b = parse(POCKET);
+    int size;
+    Board sub = RegionBot::extract(b, 0, &size);
+    EXPECT_EQ(5, size);
+    EXPECT_TRUE(sub.isFree(Board::toID(1, 2)));
+    // The border boxes stay, to be bombed open.
+    EXPECT_TRUE(sub.isBox(Board::toID(0, 3)));
+    EXPECT_TRUE(sub.isBox(Board::toID(2, 0)));
+    EXPECT_TRUE(sub.isBox(Board::toID(2, 2)));
+    // The box behind the wall, and the rest of the map, are shut off.
+    EXPECT_EQ(Board::WALL, sub.tiles[Board::toID(2, 1)]);
+    EXPECT_EQ(Board::WALL, sub.tiles[Board::toID(4, 6)]);
+    EXPECT_TRUE(sub.players[0].isAlive());
+    EXPECT_FALSE(sub.players[1].isAlive());
+}
+
+TEST(RegionBotTest, move) {
+    Board b = parse(POCKET);
+    RegionBot bot(0, BeamBot::UNSET);
+    pair<int, bool> move = bot.move(b);
+    // Without a time limit the beam runs to full depth.
+    EXPECT_EQ(BeamBot::MAX_PLIES, bot.depthReached);
+    const BeamBot& line = bot.search();
+    EXPECT_EQ(move.first, line.plan[0].dir);
+    int bombs = 0;
+    for(int i = 0; i < line.planLength; i++) {
+        if(line.plan[i].bomb) bombs++;
+    }
+    EXPECT_GE(bombs, 2);
+}
+
+// A bomb inside the pocket doesn't cut the region off behind it.
+TEST(RegionBotTest, extractThroughBomb) {
+    Board b = parse(POCKET);
+    b.placeBombOnly(0, Board::toID(0, 1), 5, 3);
+    int size;
+    Board sub = RegionBot::extract(b, 0, &size);
+    EXPECT_EQ(5, size);
+    EXPECT_EQ(Board::BOMB, sub.tiles[Board::toID(0, 1)]);
+    EXPECT_TRUE(sub.isFree(Board::toID(0, 2)));
+    EXPECT_TRUE(sub.isFree(Board::toID(1, 2)));
+    EXPECT_TRUE(sub.isBox(Board::toID(0, 3)));
+    EXPECT_TRUE(sub.isBox(Board::toID(2, 2)));
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+
+#include "SafeMoves.h"
+#include "test_boards.h"
+#include "Board.h"
+
+// Player 0 is in the corner, next to a bomb which explodes this step. Only stepping down gets out of the blast, and
+// bombing first chains our bomb into the blast, which then reaches down too.
+TEST(SafeMovesTest, certainDeath) {
+    Board b = parseStepped(
+        "13 11 0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        "1 1 1 0 2 3\n");
+    EXPECT_EQ(SafeMoves::bit(Position::NONE, false) | SafeMoves::bit(Position::NONE, true)
+              | SafeMoves::bit(Position::DOWN, false) | SafeMoves::bit(Position::DOWN, true),
+              SafeMoves::legal(b, 0));
+    EXPECT_EQ(SafeMoves::bit(Position::DOWN, false), SafeMoves::survivable(b, 0, 1));
+    EXPECT_EQ(SafeMoves::bit(Position::DOWN, false), SafeMoves::survivable(b, 0, Bomb::TIMEOUT));
+    EXPECT_TRUE(SafeMoves::allows(SafeMoves::survivable(b, 0, 1), Move(Position::DOWN, false)));
+    EXPECT_FALSE(SafeMoves::allows(SafeMoves::survivable(b, 0, 1), Move(Position::NONE, false)));
+}
+
+// Player 0 is boxed into a pocket its own bomb would cover. Bombing survives the step, but there's no way out
+// before the bomb explodes.
+TEST(SafeMovesTest, noEscape) {
+    Board b = parseStepped(
+        "13 11 0\n"
+        ".0...........\n"
+        ".X.X.X.X.X.X.\n"
+        ".0...........\n"
+        "0X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "2\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n");
+    const int bombs = SafeMoves::bit(Position::NONE, true) | SafeMoves::bit(Position::DOWN, true);
+    const int stays = SafeMoves::bit(Position::NONE, false) | SafeMoves::bit(Position::DOWN, false);
+    EXPECT_EQ(bombs | stays, SafeMoves::legal(b, 0));
+    EXPECT_EQ(bombs | stays, SafeMoves::survivable(b, 0, 1));
+    EXPECT_EQ(stays, SafeMoves::survivable(b, 0, Bomb::TIMEOUT));
+    EXPECT_EQ(stays, SafeMoves::survivable(b, 0, Bomb::TIMEOUT) & SafeMoves::NO_BOMB);
+}
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+
+#include "Territory.h"
+#include "TimePath.h"
+#include "Bot.h"
+#include "Match.h"
+
+TEST(TerritoryTest, symmetric) {
+    Board b = Match::randomBoard(3);
+    Territory territory;
+    territory.build(b);
+    // The map is symmetric, and so are the players' corners.
+    EXPECT_GT(territory.boxesFirst(0).count(), 0u);
+    EXPECT_EQ(territory.boxesFirst(0).count(), territory.boxesFirst(1).count());
+    EXPECT_EQ(territory.tilesFirst(0).count(), territory.tilesFirst(1).count());
+    EXPECT_TRUE((territory.boxesFirst(0) & territory.boxesFirst(1)).none());
+    EXPECT_EQ(0, territory.arrival(0, b.players[0].tile));
+    EXPECT_EQ(1, territory.arrival(0, Board::toID(0, 1)));
+    // On the turn's own board, the leaf query agrees with the build.
+    EXPECT_EQ((int) territory.boxesFirst(0).count(), territory.ownedBoxes(b, 0));
+}
+
+// The flood walks the timeline the way TimePath does, a layer at a time instead of a tile at a time.
+TEST(TerritoryTest, matchesTimePath) {
+    Board b = Match::randomBoard(2);
+    b.placeBomb(0);
+    b.placeBomb(1);
+    b.move(0, Position::RIGHT);
+    b.stepForward(1);
+    Territory territory;
+    territory.build(b);
+    TimePath path;
+    for(int t = 0; t < Board::TILE_COUNT; t++) {
+        TimePath::Tiles target;
+        target.set(t);
+        int expected = path.search(b, b.players[0].tile, target, Territory::HORIZON);
+        EXPECT_EQ(expected, territory.arrival(0, t)) << t;
+    }
+}
+
+// The territory term keeps the bound: pruning doesn't change the move.
+TEST(TerritoryTest, botExact) {
+    BotFactors factors = defaultBotFactors;
+    factors.territorySF = 0.2;
+    for(unsigned int seed = 1; seed <= 3; seed++) {
+        Board b = Match::randomBoard(seed);
+        Territory territory;
+        territory.build(b);
+        Bot<4> plain(0, factors);
+        plain.prune = false;
+        plain.setTerritory(&territory);
+        Bot<4> pruned(0, factors);
+        pruned.setTerritory(&territory);
+        EXPECT_EQ(plain.move(b), pruned.move(b)) << seed;
+        EXPECT_DOUBLE_EQ(plain.bestScore, pruned.bestScore) << seed;
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef HYPERSONIC_TEST_BOARDS_H
+#define HYPERSONIC_TEST_BOARDS_H
+
+#include <sstream>
+#include <string>
+
+#include "InputParser.h"
+#include "Board.h"
+
+// A board from the referee's input.
+inline Board parse(const std::string& input) {
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    return ip.parse();
+}
+
+// Stepped once, as the searches do before generating moves.
+inline Board parseStepped(const std::string& input) {
+    Board b = parse(input);
+    b.stepForward(1);
+    return b;
+}
+
+#endif //HYPERSONIC_TEST_BOARDS_H
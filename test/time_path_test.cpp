@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+
+#include "TimePath.h"
+#include "test_boards.h"
+#include "Board.h"
+
+// Player 0 is shut in the corner by a box, which player 1's bomb is about to destroy. The static distance says there
+// is no way out; over the timeline it is waiting for the blast, then walking through where the box was.
+TEST(TimePathTest, throughDestroyedBox) {
+    Board b = parseStepped(
+        "13 11 0\n"
+        ".0...........\n"
+        "XX.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        "1 1 3 0 4 3\n");
+    const int box = Board::toID(0, 1);
+    const int goal = Board::toID(0, 2);
+    EXPECT_EQ(-1, b.pathDist(Board::toID(0, 0), goal));
+    int blast = -1;
+    for(int k = 0; k < Bomb::TIMEOUT && blast == -1; k++) {
+        if(b.explodes(k)[box]) blast = k;
+    }
+    ASSERT_GE(blast, 0);
+
+    TimePath path;
+    TimePath::Tiles targets;
+    targets.set(goal);
+    // The box is passable the step after the blast, and the goal a step after that; the goal itself explodes with
+    // the box, so it can't be stood on any sooner.
+    ASSERT_EQ(blast + 3, path.search(b, Board::toID(0, 0), targets));
+    EXPECT_EQ(goal, path.target);
+    EXPECT_EQ(Board::toID(0, 0), path.tileAt(0));
+    for(int i = 0; i <= blast; i++) {
+        EXPECT_EQ(Position::NONE, path.moveAt(i)) << i;
+    }
+    EXPECT_EQ(Position::RIGHT, path.moveAt(blast + 1));
+    EXPECT_EQ(Position::RIGHT, path.moveAt(blast + 2));
+    EXPECT_EQ(box, path.tileAt(blast + 2));
+
+    // Already there.
+    EXPECT_EQ(0, path.search(b, goal, targets));
+    // Walls are never reached; the search stops once the timeline has run out and nothing new is reached.
+    TimePath::Tiles walled;
+    walled.set(Board::toID(1, 0));
+    EXPECT_EQ((int) TimePath::UNREACHABLE, path.search(b, Board::toID(0, 0), walled));
+    EXPECT_EQ((int) Board::INVALID_TILE, path.target);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <thread>
+
+#include "Params.h"
+#include "TunedParams.h"
+#include "Match.h"
+#include "Tuner.h"
+
+TEST(ParamsTest, roundTrip) {
+    ParamSet p = defaultParamSet();
+    p.bot.boxSF = 1.25;
+    p.schedule.endAcceptanceRate = 3e-9;
+    std::stringstream stream;
+    Params::save(stream, p);
+    ParamSet loaded = defaultParamSet();
+    ASSERT_TRUE(Params::load(stream, loaded));
+    EXPECT_EQ(1.25, loaded.bot.boxSF);
+    EXPECT_EQ(3e-9, loaded.schedule.endAcceptanceRate);
+    EXPECT_EQ(p.score.victory, loaded.score.victory);
+    // Names the bot doesn't know are rejected.
+    std::istringstream bad("bot.unknown 1\n");
+    EXPECT_FALSE(Params::load(bad, loaded));
+}
+
+TEST(ParamsTest, defaultsMatchHeader) {
+    // The generated header should reproduce the defaults it was generated from.
+    ParamSet p = defaultParamSet();
+    std::ostringstream header;
+    Params::writeHeader(header, p);
+    EXPECT_NE(std::string::npos, header.str().find("0.875,    // boxDepreciation"));
+    EXPECT_NE(std::string::npos, header.str().find("-200    // defeat"));
+    Param all[Params::MAX_PARAMS];
+    int count = Params::list(p, all);
+    for(int i = 0; i < count; i++) {
+        EXPECT_GE(*all[i].value, all[i].min) << all[i].name;
+        EXPECT_LE(*all[i].value, all[i].max) << all[i].name;
+    }
+}
+
+TEST(MatchTest, randomBoard) {
+    Board b = Match::randomBoard(3);
+    for(int y = 0; y < Board::HEIGHT; y++) {
+        for(int x = 0; x < Board::WIDTH; x++) {
+            EXPECT_EQ(b.tiles[Board::toID(y, x)], b.tiles[Board::toID(Board::HEIGHT - 1 - y, Board::WIDTH - 1 - x)]);
+        }
+    }
+    EXPECT_TRUE(b.isFree(b.players[0].tile));
+    EXPECT_TRUE(b.isFree(b.players[1].tile));
+    EXPECT_EQ(Board::WALL, b.tiles[Board::toID(1, 1)]);
+    EXPECT_GT(b.totalBoxes, 0);
+}
+
+TEST(MatchTest, play) {
+    ParamSet p = defaultParamSet();
+    BotPlayer<2> first(0, p);
+    BotPlayer<2> second(1, p);
+    MatchResult r = Match::play(&first, &second, 5, 30);
+    EXPECT_LE(r.turns, 30);
+    EXPECT_GT(r.boxes[0] + r.boxes[1], 0);
+}
+
+static void playInto(unsigned int seed, MatchResult* out) {
+    ParamSet p = defaultParamSet();
+    BotPlayer<3> first(0, p);
+    BotPlayer<3> second(1, p);
+    *out = Match::play(&first, &second, seed, 40);
+}
+
+// Games on different threads share no state, so they play out exactly as they do one at a time.
+TEST(MatchTest, concurrent) {
+    const int games = 4;
+    MatchResult alone[games];
+    for(int g = 0; g < games; g++) {
+        playInto(g + 1, &alone[g]);
+    }
+    MatchResult together[games];
+    std::thread threads[games];
+    for(int g = 0; g < games; g++) {
+        threads[g] = std::thread(playInto, g + 1, &together[g]);
+    }
+    for(int g = 0; g < games; g++) {
+        threads[g].join();
+        EXPECT_EQ(alone[g].turns, together[g].turns) << g;
+        EXPECT_EQ(alone[g].boxes[0], together[g].boxes[0]) << g;
+        EXPECT_EQ(alone[g].boxes[1], together[g].boxes[1]) << g;
+        EXPECT_EQ(alone[g].winner, together[g].winner) << g;
+    }
+}
+
+TEST(TunerTest, step) {
+    TunerConfig config;
+    config.games = 2;
+    config.workers = 2;
+    config.maxTurns = 10;
+    Tuner tuner(config, defaultParamSet());
+    EXPECT_EQ(7, tuner.tunedParams());
+    ParamSet before = tuner.current;
+    double y = tuner.step();
+    EXPECT_GE(y, -1);
+    EXPECT_LE(y, 1);
+    EXPECT_EQ(1, tuner.iteration);
+    // Only the exhaustive search's parameters are tuned.
+    EXPECT_EQ(before.score.victory, tuner.current.score.victory);
+    EXPECT_EQ(before.schedule.initTemp, tuner.current.schedule.initTemp);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "TurnContext.h"
+#include "Mechanics.h"
+#include "InputParser.h"
+#include "Board.h"
+
+// A row of boxes splits the map in two, with one of them bombed.
+TEST(TurnContextTest, build) {
+    std::string input =
+        "13 11 0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "0X0X0X0X0X0X0\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        ".X.X.X.X.X.X.\n"
+        ".............\n"
+        "3\n"
+        "0 0 0 0 1 3\n"
+        "0 1 12 10 1 3\n"
+        "1 0 0 4 3 3\n";
+    std::istringstream stream(input);
+    InputParser ip(stream);
+    ip.init();
+    Board b = ip.parse();
+    TurnContext context;
+    context.build(b);
+
+    EXPECT_EQ(7, context.boxCount());
+    EXPECT_EQ(6, context.targetCount());
+    EXPECT_TRUE(context.isDoomed(Board::toID(5, 0)));
+    EXPECT_TRUE(context.isTarget(Board::toID(5, 2)));
+    EXPECT_EQ(3, context.minBombTimer());
+
+    EXPECT_EQ(2, context.regionCount());
+    EXPECT_EQ((int) TurnContext::NO_REGION, context.region(Board::toID(4, 0)));
+    EXPECT_NE(context.region(Board::toID(0, 0)), context.region(Board::toID(10, 12)));
+    EXPECT_EQ(52, context.regionSize(Board::toID(0, 0)));
+    EXPECT_EQ(53, context.regionSize(Board::toID(10, 12)));
+    EXPECT_FALSE(context.enemyConnected(0));
+
+    EXPECT_EQ(2, context.escapes(Board::toID(0, 0)));
+    EXPECT_EQ(2, context.escapes(Board::toID(1, 0)));
+    EXPECT_EQ(4, context.escapes(Board::toID(2, 2)));
+
+    // Skipping the doomed boxes through the context gives the same distances.
+    for(int p = 0; p < 2; p++) {
+        EXPECT_EQ(BoardStats::stepsToClosestBox(b, p), BoardStats::stepsToClosestBox(b, p, &context));
+    }
+}